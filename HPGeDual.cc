@@ -16,9 +16,24 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
 #include "SteppingAction.hh"
+#include "CascadeBenchmark.hh"
+#include "CascadeFilter.hh"
+#include "CascadeMessenger.hh"
+#include "EmissionBiasing.hh"
+#include "G4CASCADEArchive.hh"
+#include "G4CASCADECatalog.hh"
+#include "G4RDDataCache.hh"
+#include "RAINIERCascadeStore.hh"
+#include "RAINIERFileList.hh"
+#include "RAINIERSampler.hh"
+#include "RAINIERStreamReader.hh"
+#include "RAINIERTextReader.hh"
 
 #include "G4SystemOfUnits.hh"
+#include "TROOT.h"
+#include <cstdlib>
 #include <iostream>
+#include <random>
 #include <string>
 #include <sstream>
 #include <thread>
@@ -41,20 +56,87 @@ void PrintUsage() {
     G4cout << "  ./HPGeDual [options] [RAINIER_file] [macro_file]" << G4endl;
     G4cout << "\nOptions:" << G4endl;
     G4cout << "  -angle <degrees>    : Angle for second detector (default: 180.0)" << G4endl;
+    G4cout << "  -bias-cones [f]     : In a fraction f (default: 0.5) of the events emit one primary, chosen" << G4endl;
+    G4cout << "                        at random, into the cones seen through the two collimator openings" << G4endl;
+    G4cout << "                        and weight the event to compensate (ntuple column w, weighted" << G4endl;
+    G4cout << "                        spectra); weights stay below 1/(1-f). Quote statistical errors with" << G4endl;
+    G4cout << "                        the effective event count printed with the spectra, not the simulated one" << G4endl;
     G4cout << "  -coin               : Generate Co-60 coincidences (2 gammas per event)" << G4endl;
     G4cout << "  -single             : Generate single gammas (1 gamma per event)" << G4endl;
     G4cout << "  -cascade [Z A Sn]   : Generate CASCADE gamma cascades (realistic neutron capture)" << G4endl;
     G4cout << "                        Z  = Atomic number (default: 17 for Cl)" << G4endl;
     G4cout << "                        A  = Mass number (default: 36)" << G4endl;
     G4cout << "                        Sn = Neutron separation energy in MeV (default: 8.579)" << G4endl;
+    G4cout << "  -cascade-block <N>  : Cascades pre-generated per block in CASCADE mode (default: 1)" << G4endl;
+    G4cout << "                        Faster for large N. N > 1 with more than one thread makes the" << G4endl;
+    G4cout << "                        results depend on which thread runs which event: the same seed" << G4endl;
+    G4cout << "                        no longer reproduces a run. N = 1 keeps MT runs reproducible" << G4endl;
+    G4cout << "  -tabulated-relaxation" << G4endl;
+    G4cout << "                      : Draw the X-rays after internal conversion as one tabulated" << G4endl;
+    G4cout << "                        relaxation chain instead of vacancy by vacancy" << G4endl;
     G4cout << "  -RAINIER <file>     : Use RAINIER ROOT file as cascade source" << G4endl;
-    G4cout << "                        File should be RAINIER simulation output (Run####.root)" << G4endl;
-    G4cout << "  -two-gamma-only     : For RAINIER mode, only use cascades with exactly 2 gammas" << G4endl;
-    G4cout << "                        AND total energy > 5.4 MeV" << G4endl;
+    G4cout << "                        File should be RAINIER simulation output (Run####.root)," << G4endl;
+    G4cout << "                        a quoted glob (\"out/Run*.root\") or a .list/.txt file with one" << G4endl;
+    G4cout << "                        file or glob per line; each thread reads its own share of them" << G4endl;
+    G4cout << "                        A .dat or .txt cascade list (one cascade of energies in MeV per" << G4endl;
+    G4cout << "                        line, optionally \"I: E1 E2 ...\" with intensity I, or a" << G4endl;
+    G4cout << "                        gamma_pairs.txt table) is read into memory and drawn by intensity" << G4endl;
+    G4cout << "  -rainier-tree <name>: Name of the tree in the RAINIER files (default: tree)" << G4endl;
+    G4cout << "  -filter <spec>      : Only use cascades passing all comma-separated criteria:" << G4endl;
+    G4cout << "                        mult=N[-M] gamma count, esum=A-[B] summed energy (MeV)," << G4endl;
+    G4cout << "                        line=E[/tol] a gamma near E, level=E[/tol] an intermediate" << G4endl;
+    G4cout << "                        level near E (tol in MeV, default 0.002). RAINIER cascades" << G4endl;
+    G4cout << "                        are selected as they are read, CASCADE cascades are drawn" << G4endl;
+    G4cout << "                        from the level scheme conditioned on the filter" << G4endl;
     G4cout << "                        Default: allow all cascade multiplicities" << G4endl;
+    G4cout << "  -two-gamma-only     : Same as -filter mult=2,esum=5.4- (exactly 2 gammas AND" << G4endl;
+    G4cout << "                        total energy > 5.4 MeV)" << G4endl;
+    G4cout << "  -rainier-index      : Keep the entries the filter accepts in an index next to each" << G4endl;
+    G4cout << "                        RAINIER file (<file>.<key>.idx), built on first use; later" << G4endl;
+    G4cout << "                        runs with the same filter read only those entries" << G4endl;
+    G4cout << "  -rainier-preload    : Read the accepted RAINIER cascades into memory once and share" << G4endl;
+    G4cout << "                        them between threads instead of reading the file every event" << G4endl;
+    G4cout << "  -rainier-sample <mode>" << G4endl;
+    G4cout << "                      : Order of preloaded cascades: sequential (default, file order)," << G4endl;
+    G4cout << "                        shuffle (each thread draws its share without replacement, in" << G4endl;
+    G4cout << "                        a new random order every pass) or stratified (the same, with" << G4endl;
+    G4cout << "                        multiplicities kept in library proportions); implies" << G4endl;
+    G4cout << "                        -rainier-preload for ROOT files" << G4endl;
+    G4cout << "  -rainier-seed <N>   : Seed of -rainier-sample (default: random, printed at start)" << G4endl;
+    G4cout << "  -rainier-stream [depth]" << G4endl;
+    G4cout << "                      : Read RAINIER cascades in a separate thread that feeds the workers" << G4endl;
+    G4cout << "                        through a ring of <depth> cascades (default: 4096); for files" << G4endl;
+    G4cout << "                        too large to preload" << G4endl;
     G4cout << "  -threads <N>        : Number of threads for parallel execution (default: 1)" << G4endl;
     G4cout << "                        Use 'auto' or 0 to use all available CPU cores" << G4endl;
     G4cout << "  -quiet              : Suppress all non-essential output" << G4endl;
+    G4cout << "  -list-isotopes      : List isotopes with CASCADE data and their Sn, then exit" << G4endl;
+    G4cout << "  -build-archive [file]" << G4endl;
+    G4cout << "                      : Pack CapGamData/*.bin into one memory-mapped archive" << G4endl;
+    G4cout << "                        (default: <CapGamData>/CapGamData.arc) and exit" << G4endl;
+    G4cout << "  -build-eadl-cache [file]" << G4endl;
+    G4cout << "                      : Parse the G4LEDATA fluorescence, Auger and binding data into a" << G4endl;
+    G4cout << "                        binary cache (default: $G4RD_DATA_CACHE or" << G4endl;
+    G4cout << "                        ~/.cache/HPGeDual/G4LEDATA.cache) and exit" << G4endl;
+    G4cout << "  -exact Z A [file]   : Write exact CASCADE line intensities, gamma multiplicities and" << G4endl;
+    G4cout << "                        gamma-gamma pair probabilities (to file or stdout) and exit" << G4endl;
+    G4cout << "  -bench-memory Z A [N]" << G4endl;
+    G4cout << "                      : Generate N CASCADE events (default: 10000000) and check" << G4endl;
+    G4cout << "                        that the resident memory stays flat, then exit" << G4endl;
+    G4cout << "  -bench-block Z A [N]" << G4endl;
+    G4cout << "                      : Time CASCADE block pre-generation for block sizes 1..65536" << G4endl;
+    G4cout << "                        (N events each, default: 200000) and exit" << G4endl;
+    G4cout << "  -bench-atomic [Z]   : Time and RSS of loading the atomic relaxation tables for" << G4endl;
+    G4cout << "                        element Z (default: 17) against loading all elements, and exit" << G4endl;
+    G4cout << "  -bench-relaxation [Z] [N]" << G4endl;
+    G4cout << "                      : Compare tabulated and stepwise atomic relaxation of element Z" << G4endl;
+    G4cout << "                        (default: 17) with N draws per vacancy (default: 1000000), and exit" << G4endl;
+    G4cout << "  -bench-text [file|MB]" << G4endl;
+    G4cout << "                      : Time parsing of a text cascade list, or of a synthetic one of" << G4endl;
+    G4cout << "                        MB megabytes (default: 1024), and exit" << G4endl;
+    G4cout << "  -bench-branching Z A [N]" << G4endl;
+    G4cout << "                      : Time CASCADE branch sampling on N cascades (default: 1000000)" << G4endl;
+    G4cout << "                        and exit without running the simulation" << G4endl;
     G4cout << "  -h, --help          : Show this help message" << G4endl;
     G4cout << "\nArguments:" << G4endl;
     G4cout << "  RAINIER_file        : Optional RAINIER data file (uses Co-60 test data if not provided)" << G4endl;
@@ -73,6 +155,7 @@ void PrintUsage() {
     G4cout << "  ./HPGeDual -RAINIER Run0001.root     # Use RAINIER cascades from file" << G4endl;
     G4cout << "  ./HPGeDual -RAINIER Run0001.root -threads 4  # RAINIER with 4 cores" << G4endl;
     G4cout << "  ./HPGeDual -RAINIER Run0001.root -two-gamma-only  # Only 2-gamma, E>5.4 MeV" << G4endl;
+    G4cout << "  ./HPGeDual -cascade -filter line=1.951,mult=2-4   # Cascades with the 1951 keV line" << G4endl;
     G4cout << "\n" << G4endl;
 }
 
@@ -84,6 +167,7 @@ int main(int argc, char** argv)
     SourceMode sourceMode = CO60_CASCADE;  // Default source mode
     std::string rainierFile = "";
     G4double detector2Angle = 180.0;
+    G4double biasFraction = 0.;  // 0: isotropic emission
     std::string macroFile = "";
 
     // CASCADE isotope parameters (defaults: Cl-36)
@@ -94,8 +178,18 @@ int main(int argc, char** argv)
     // Multi-threading parameter
     G4int nThreads = 1;  // Default: single-threaded
 
-    // RAINIER filter parameter
-    bool twoGammaOnly = false;  // Default: allow all cascade multiplicities
+    // CASCADE pre-generation block size
+    G4int cascadeBlockSize = CascadeBlockBuffer::kDefaultBlockSize;
+    bool tabulatedRelaxation = false;
+
+    // RAINIER files; the cascade filter is parsed into CascadeFilter::Instance()
+    std::string rainierTreeName = RAINIERFileList::kDefaultTreeName;
+    bool rainierPreload = false;
+    bool rainierIndex = false;
+    RAINIERSampler::Mode rainierSampling = RAINIERSampler::kSequential;
+    unsigned long long rainierSeed = 0;
+    bool rainierSeedGiven = false;
+    G4int rainierStreamDepth = 0;  // 0: no reader thread
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -136,6 +230,19 @@ int main(int argc, char** argv)
                 }
             }
         }
+        else if (arg == "-cascade-block") {
+            if (i + 1 < argc) {
+                std::stringstream ss(argv[i + 1]);
+                if (!(ss >> cascadeBlockSize) || cascadeBlockSize < 1) {
+                    if (!quietMode) G4cout << "Error: Invalid block size '" << argv[i + 1] << "'" << G4endl;
+                    cascadeBlockSize = CascadeBlockBuffer::kDefaultBlockSize;
+                }
+                i++;
+            }
+        }
+        else if (arg == "-tabulated-relaxation") {
+            tabulatedRelaxation = true;
+        }
         else if (arg == "-RAINIER") {
             if (i + 1 < argc) {
                 rainierFile = argv[i + 1];
@@ -161,6 +268,25 @@ int main(int argc, char** argv)
                 i++;
             }
         }
+        else if (arg == "-bias-cones") {
+            // The fraction is optional, as the depth of -rainier-stream
+            biasFraction = EmissionBiasing::kDefaultFraction;
+            if (i + 1 < argc) {
+                std::stringstream ss(argv[i + 1]);
+                G4double fraction = 0.;
+                if (ss >> fraction && ss.eof()) {
+                    if (fraction <= 0. || fraction >= 1.) {
+                        if (!quietMode) {
+                            G4cout << "Error: -bias-cones needs a fraction between 0 and 1, not '"
+                                   << argv[i + 1] << "'" << G4endl;
+                        }
+                        return 1;
+                    }
+                    biasFraction = fraction;
+                    i++;
+                }
+            }
+        }
         else if (arg == "-threads") {
             if (i + 1 < argc) {
                 std::string threadArg = argv[i + 1];
@@ -177,10 +303,101 @@ int main(int argc, char** argv)
                 i++;
             }
         }
+        else if (arg == "-list-isotopes") {
+            g_quietMode = true;
+            G4CASCADECatalog::Instance()->ListIsotopes();
+            return G4CASCADECatalog::Instance()->Initialize() ? 0 : 1;
+        }
+        else if (arg == "-build-archive") {
+            g_quietMode = quietMode;
+            G4String dataDir = G4CASCADECatalog::Instance()->GetDataDirectory();
+            if (dataDir.empty()) return 1;
+            G4String outputPath = dataDir + "/" + G4CASCADEArchive::kFileName;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                outputPath = argv[i + 1];
+            }
+            return (G4CASCADEArchive::Build(dataDir, outputPath) > 0) ? 0 : 1;
+        }
+        else if (arg == "-build-eadl-cache") {
+            g_quietMode = quietMode;
+            const char* dataDir = std::getenv("G4LEDATA");
+            G4String outputPath = G4RDDataCache::DefaultPath();
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                outputPath = argv[i + 1];
+            }
+            return (G4RDDataCache::Build(dataDir ? dataDir : "", outputPath) > 0) ? 0 : 1;
+        }
+        else if (CascadeBenchmark::IsCommand(arg)) {
+            // Stand-alone tables and benchmarks take the rest of the line
+            return CascadeBenchmark::RunCommand(argc - i, argv + i);
+        }
         else if (arg == "-two-gamma-only") {
-            twoGammaOnly = true;
+            CascadeFilter::Instance()->Parse(CascadeFilter::kTwoGammaOnly);
             if (!quietMode) {
-                G4cout << "RAINIER filter: Only 2-gamma cascades with E_total > 5.4 MeV will be used" << G4endl;
+                G4cout << "Cascade filter: Only 2-gamma cascades with E_total > 5.4 MeV will be used" << G4endl;
+            }
+        }
+        else if (arg == "-filter") {
+            if (i + 1 < argc) {
+                if (!CascadeFilter::Instance()->Parse(argv[i + 1])) return 1;
+                i++;
+            } else {
+                if (!quietMode) {
+                    G4cout << "Error: -filter requires a list of criteria" << G4endl;
+                }
+                return 1;
+            }
+        }
+        else if (arg == "-rainier-tree") {
+            if (i + 1 < argc) {
+                rainierTreeName = argv[i + 1];
+                i++;
+            } else {
+                if (!quietMode) {
+                    G4cout << "Error: -rainier-tree requires a tree name" << G4endl;
+                }
+                return 1;
+            }
+        }
+        else if (arg == "-rainier-preload") {
+            rainierPreload = true;
+        }
+        else if (arg == "-rainier-index") {
+            rainierIndex = true;
+        }
+        else if (arg == "-rainier-sample") {
+            if (i + 1 >= argc || !RAINIERSampler::ParseMode(argv[i + 1], rainierSampling)) {
+                if (!quietMode) {
+                    G4cout << "Error: -rainier-sample requires sequential, shuffle or stratified" << G4endl;
+                }
+                return 1;
+            }
+            i++;
+        }
+        else if (arg == "-rainier-seed") {
+            std::stringstream ss(i + 1 < argc ? argv[i + 1] : "");
+            if (!(ss >> rainierSeed)) {
+                if (!quietMode) G4cout << "Error: -rainier-seed requires a number" << G4endl;
+                return 1;
+            }
+            rainierSeedGiven = true;
+            i++;
+        }
+        else if (arg == "-rainier-stream") {
+            // The depth is optional: a following macro or RAINIER file is
+            // left for the next round
+            rainierStreamDepth = RAINIERStreamReader::kDefaultDepth;
+            if (i + 1 < argc) {
+                std::stringstream ss(argv[i + 1]);
+                G4int depth = 0;
+                if (ss >> depth && ss.eof()) {
+                    if (depth < 1) {
+                        if (!quietMode) G4cout << "Error: Invalid ring depth '" << argv[i + 1] << "'" << G4endl;
+                        return 1;
+                    }
+                    rainierStreamDepth = depth;
+                    i++;
+                }
             }
         }
         else if (arg.find(".mac") != std::string::npos) {
@@ -188,6 +405,7 @@ int main(int argc, char** argv)
         }
         else if (arg.find(".txt") != std::string::npos || arg.find(".dat") != std::string::npos) {
             rainierFile = arg;
+            sourceMode = CASCADE_RAINIER;
         }
         else if (rainierFile.empty() && macroFile.empty()) {
             rainierFile = arg;
@@ -203,6 +421,29 @@ int main(int argc, char** argv)
     // Set the global quiet mode flag
     g_quietMode = quietMode;
 
+    // Resolve the CASCADE data once, before any thread exists: a bad data
+    // path stops here instead of on the first event of every worker
+    if (sourceMode == CASCADE_DIRECT) {
+        G4CASCADECatalog* catalog = G4CASCADECatalog::Instance();
+        if (!catalog->Initialize()) {
+            return 1;
+        }
+        if (!catalog->HasIsotope(cascadeZ, cascadeA)) {
+            G4cerr << "WARNING: No CASCADE data for Z=" << cascadeZ
+                   << " A=" << cascadeA << " (see -list-isotopes)" << G4endl;
+            G4cerr << "         Falling back to default Cl-36 (Z=17, A=36, Sn=8.579 MeV)"
+                   << G4endl;
+            cascadeZ = 17;
+            cascadeA = 36;
+            cascadeSn = 8.579;
+        }
+        if (cascadeBlockSize > 1 && nThreads > 1) {
+            G4cerr << "WARNING: -cascade-block " << cascadeBlockSize << " with " << nThreads
+                   << " threads: results depend on event-to-thread scheduling and are not reproducible"
+                   << G4endl;
+        }
+    }
+
     // Print startup info only if not in quiet mode
     if (!quietMode) {
         G4cout << "\n========================================" << G4endl;
@@ -238,6 +479,74 @@ int main(int argc, char** argv)
         G4cout << G4endl;
     }
 
+    // Preloaded RAINIER cascades, shared read-only by all workers, or a
+    // reader thread that streams them
+    if (rainierPreload && rainierStreamDepth > 0) {
+        G4cerr << "ERROR: -rainier-preload and -rainier-stream cannot be combined" << G4endl;
+        return 1;
+    }
+    // Random orders are drawn over cascades held in memory
+    if (rainierSampling != RAINIERSampler::kSequential) {
+        if (rainierStreamDepth > 0) {
+            G4cerr << "ERROR: -rainier-sample and -rainier-stream cannot be combined" << G4endl;
+            return 1;
+        }
+        rainierPreload = true;
+        if (!rainierSeedGiven) rainierSeed = ((unsigned long long)std::random_device{}() << 32) ^ std::random_device{}();
+        if (!quietMode) {
+            G4cout << "RAINIER sampling: " << RAINIERSampler::ModeName(rainierSampling)
+                   << ", seed " << rainierSeed << " (repeat with -rainier-seed)" << G4endl;
+        }
+    }
+    RAINIERSampler::Configure(rainierSampling, rainierSeed, nThreads);
+    // Every RAINIER file is opened and counted before any thread exists: a
+    // missing or damaged file stops here instead of in the middle of a run.
+    // A text cascade list is parsed into memory instead.
+    RAINIERFileList* rainierFiles = RAINIERFileList::Instance();
+    RAINIERCascadeStore* rainierStore = nullptr;
+    if (sourceMode == CASCADE_RAINIER && !rainierFile.empty() &&
+        RAINIERTextReader::IsCascadeText(rainierFile)) {
+        if (rainierStreamDepth > 0) {
+            G4cerr << "ERROR: -rainier-stream needs ROOT files; " << rainierFile
+                   << " is a text cascade list" << G4endl;
+            return 1;
+        }
+        if (CascadeFilter::Instance()->NeedsLevels()) {
+            G4cerr << "ERROR: A level criterion needs the Exfs branch of RAINIER ROOT files; "
+                   << rainierFile << " is a text cascade list" << G4endl;
+            return 1;
+        }
+        rainierStore = RAINIERCascadeStore::LoadText(rainierFile, *CascadeFilter::Instance());
+        if (!rainierStore) return 1;
+        if (rainierStore->IsWeighted() && rainierSampling != RAINIERSampler::kSequential) {
+            G4cerr << "WARNING: The cascades of " << rainierFile << " are drawn by intensity;"
+                   << " -rainier-sample is ignored" << G4endl;
+        }
+    } else if (sourceMode == CASCADE_RAINIER && !rainierFile.empty()) {
+        if (!rainierFiles->Open(rainierFile, rainierTreeName)) return 1;
+        if (rainierIndex && !rainierFiles->LoadIndex(*CascadeFilter::Instance())) return 1;
+        if (!rainierPreload && rainierStreamDepth == 0) rainierFiles->Assign(nThreads);
+    }
+    // With an index only the accepted entries are read
+    const std::vector<G4long>* rainierEntries =
+        rainierFiles->HasIndex() ? &rainierFiles->GetAcceptedEntries() : nullptr;
+    if (rainierPreload && rainierFiles->IsOpen()) {
+        rainierStore = RAINIERCascadeStore::Load(rainierFiles->GetFiles(), rainierTreeName,
+                                                *CascadeFilter::Instance(), rainierEntries);
+        if (!rainierStore) return 1;
+    }
+    // Every worker or the stream reader opens its RAINIER files with its
+    // own TChain; ROOT's global state must be locked before a second thread
+    // touches ROOT, which the reader thread does even in a sequential run
+    if (!rainierFile.empty() && !rainierStore && (nThreads > 1 || rainierStreamDepth > 0)) {
+        ROOT::EnableThreadSafety();
+    }
+    if (rainierStreamDepth > 0 && rainierFiles->IsOpen()) {
+        if (!RAINIERStreamReader::Instance()->Start(rainierFiles->GetFiles(), rainierTreeName,
+                                                    *CascadeFilter::Instance(), rainierStreamDepth,
+                                                    rainierEntries)) return 1;
+    }
+
     // Create run manager (MT or ST depending on nThreads)
     G4RunManager* runManager = nullptr;
     if (nThreads > 1) {
@@ -280,13 +589,20 @@ int main(int argc, char** argv)
     DetectorConstruction* detConstruction = new DetectorConstruction(detector2Angle);
     runManager->SetUserInitialization(detConstruction);
 
+    // Biased emission towards the collimators, set before any worker exists
+    if (biasFraction > 0.) {
+        EmissionBiasing::Instance()->Configure(biasFraction, *detConstruction);
+        if (!quietMode) EmissionBiasing::Instance()->PrintConfiguration();
+    }
+
     PhysicsList* physicsList = new PhysicsList();
     runManager->SetUserInitialization(physicsList);
 
     // Use ActionInitialization for MT-safe action setup
     ActionInitialization* actionInitialization =
         new ActionInitialization(rainierFile, cascadeMode, sourceMode,
-                                cascadeZ, cascadeA, cascadeSn, twoGammaOnly);
+                                cascadeZ, cascadeA, cascadeSn,
+                                cascadeBlockSize, tabulatedRelaxation, rainierStore);
     runManager->SetUserInitialization(actionInitialization);
 
     // Initialize visualization (only if not quiet mode)
@@ -298,6 +614,7 @@ int main(int argc, char** argv)
 
     // Get the pointer to the User Interface manager
     G4UImanager* UImanager = G4UImanager::GetUIpointer();
+    CascadeMessenger* cascadeMessenger = new CascadeMessenger();
 
     // COMPREHENSIVE UI COMMAND SUPPRESSION
     // ===================================
@@ -347,8 +664,11 @@ int main(int argc, char** argv)
     }
 
     // Clean up
+    delete cascadeMessenger;
     if (visManager) delete visManager;
     delete runManager;
+    RAINIERStreamReader::Instance()->Stop();
+    delete rainierStore;
 
     // Final message (always shown unless completely silent)
     if (!quietMode) {
@@ -19,7 +19,9 @@ public:
                         G4int cascadeZ = 17,
                         G4int cascadeA = 36,
                         G4double cascadeSn = 8.579,
-                        bool twoGammaOnly = false);
+                        G4int cascadeBlockSize = CascadeBlockBuffer::kDefaultBlockSize,
+                        bool tabulatedRelaxation = false,
+                        const RAINIERCascadeStore* rainierStore = nullptr);
     virtual ~ActionInitialization();
 
     virtual void BuildForMaster() const;
@@ -32,7 +34,9 @@ private:
     G4int fCascadeZ;
     G4int fCascadeA;
     G4double fCascadeSn;
-    bool fTwoGammaOnly;
+    G4int fCascadeBlockSize;
+    bool fTabulatedRelaxation;
+    const RAINIERCascadeStore* fRAINIERStore;  // Preloaded by main(), shared by all workers
 };
 
 #endif
@@ -0,0 +1,68 @@
+// ==============================================================================
+// CascadeBenchmark.hh - Stand-alone timing of the CASCADE generator internals
+// ==============================================================================
+//
+// Run from the command line (see PrintUsage in HPGeDual.cc); no Geant4 run
+// manager is created. The exact CASCADE tables of -exact are written from
+// here as well, since they take the same arguments.
+
+#ifndef CascadeBenchmark_h
+#define CascadeBenchmark_h 1
+
+#include "globals.hh"
+#include <string>
+
+class CascadeBenchmark
+{
+  public:
+    // Whether arg is a stand-alone command run by RunCommand
+    static G4bool IsCommand(const std::string& arg);
+
+    // Runs the command args[0] with the arguments args[1], ..., args[argc-1]
+    // that follow it on the command line, and returns the exit code
+    static G4int RunCommand(G4int argc, char** args);
+
+    // Exact line intensities, multiplicities and pair probabilities of
+    // (Z, A) written to fileName, or to G4cout if it is empty
+    static G4int RunExact(G4int Z, G4int A, const std::string& fileName);
+
+    // Transitions per second of the alias-table branch sampling against the
+    // cumulative-sum scan it replaced, on cascades of isotope (Z, A).
+    // Returns 0 on success, non-zero if the isotope has no data.
+    static G4int RunBranching(G4int Z, G4int A, G4long nCascades);
+
+    // Generates nEvents cascades of (Z, A) from the capture state with one
+    // G4CASCADE and samples the resident set size along the way. Returns
+    // non-zero if memory keeps growing after the warm-up tenth of the run.
+    static G4int RunMemory(G4int Z, G4int A, G4long nEvents);
+
+    // Generator ns/event of block pre-generation (CascadeBlockBuffer) for
+    // block sizes 1, 4, ..., 65536. Between events a tracking-sized working
+    // set is touched so that, as in a real run, the generator does not keep
+    // the caches to itself; only the generator time is reported.
+    static G4int RunBlockSizes(G4int Z, G4int A, G4long nEvents);
+
+    // Time and resident set size of the atomic relaxation tables: creating
+    // G4RDAtomicTransitionManager, loading element Z on first use, and then
+    // loading every element as the manager used to do on construction
+    static G4int RunAtomicStartup(G4int Z);
+
+    // Checks the whole-chain relaxation tables (G4RDRelaxationChains) of
+    // element Z against the vacancy-by-vacancy sampler: nDraws relaxations
+    // of a K, L1 and M1 vacancy with each, a two-sample chi-square test on
+    // the photon-energy sequences, and the time per relaxation. Returns
+    // non-zero if the element has no data or a test fails at the 0.1% level.
+    static G4int RunRelaxation(G4int Z, G4long nDraws);
+
+    // Parse throughput of RAINIERTextReader on the cascade list fileName
+    // against a getline/istringstream loop, then the time to load it into
+    // a RAINIERCascadeStore and to draw a cascade from it. Without a file a
+    // synthetic RAINIER-style list of about megabytes MB is written to the
+    // current directory, used, and removed.
+    static G4int RunTextParse(const std::string& fileName, G4long megabytes);
+
+    // Resident set size of the process in bytes (0 if unavailable)
+    static G4long ResidentSetSize();
+};
+
+#endif
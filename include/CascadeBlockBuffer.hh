@@ -0,0 +1,74 @@
+// ==============================================================================
+// CascadeBlockBuffer.hh - Block of pre-generated CASCADE gamma cascades
+// ==============================================================================
+//
+// Structure-of-arrays store for a block of cascades generated in one go, so
+// that cascade sampling runs in a tight loop instead of being interleaved
+// with tracking event by event. Cascade i owns the gammas
+// [Offset(i), Offset(i) + Multiplicity(i)). Only photons (nuclear gammas and
+// X-rays) are kept; conversion and Auger electrons are dropped.
+//
+// A block is drawn from the random engine of the event that triggers the
+// refill, so with blocks larger than 1 the cascade of an event depends on
+// which events the same worker ran before it. G4MTRunManager hands events
+// to the workers as they become free, so such a run is not repeatable, and
+// an event cannot be re-run from its saved seed. Blocks are therefore
+// opt-in (-cascade-block N); the default of 1 draws every cascade from its
+// own event.
+
+#ifndef CascadeBlockBuffer_h
+#define CascadeBlockBuffer_h 1
+
+#include "globals.hh"
+#include "G4CASCADEBuffer.hh"
+#include <vector>
+
+class G4CASCADE;
+class G4Fragment;
+
+class CascadeBlockBuffer
+{
+public:
+    static const G4int kDefaultBlockSize = 1;
+
+    explicit CascadeBlockBuffer(G4int blockSize = kDefaultBlockSize);
+
+    void SetBlockSize(G4int blockSize);
+    G4int GetBlockSize() const { return fBlockSize; }
+
+    // Discards the remaining cascades (e.g. after the isotope changed)
+    void Invalidate() { fNext = NumberOfCascades(); }
+
+    // Replaces the block with BlockSize() new cascades of nucleus
+    void Refill(G4CASCADE& generator, const G4Fragment& nucleus);
+
+    // Index of the next unused cascade, refilling the block when it is used up
+    G4int NextCascade(G4CASCADE& generator, const G4Fragment& nucleus)
+    {
+        if (fNext >= NumberOfCascades()) Refill(generator, nucleus);
+        return fNext++;
+    }
+
+    G4int NumberOfCascades() const { return (G4int)fMultiplicity.size(); }
+    G4int Offset(G4int cascade) const { return fOffset[cascade]; }
+    G4int Multiplicity(G4int cascade) const { return fMultiplicity[cascade]; }
+
+    G4double Energy(G4int gamma) const { return fEnergy[gamma]; }
+    G4ThreeVector Direction(G4int gamma) const
+    { return G4ThreeVector(fDirX[gamma], fDirY[gamma], fDirZ[gamma]); }
+
+private:
+    G4int fBlockSize;
+    G4int fNext;
+
+    std::vector<G4int> fOffset;         // first gamma of each cascade
+    std::vector<G4int> fMultiplicity;   // gammas per cascade
+    std::vector<G4double> fEnergy;
+    std::vector<G4double> fDirX;
+    std::vector<G4double> fDirY;
+    std::vector<G4double> fDirZ;
+
+    G4CASCADEBuffer fScratch;           // output of one GenerateCascade call
+};
+
+#endif
@@ -0,0 +1,120 @@
+// ==============================================================================
+// CascadeFilter.hh - Selection of gamma cascades before tracking
+// ==============================================================================
+//
+// The selection given with -filter is parsed once in main(), before any
+// thread exists, and applied to every cascade source:
+//
+//   RAINIER   preloaded and text cascades are evaluated in batches while
+//             they are loaded (Evaluate), one criterion at a time over
+//             flat arrays; cascades read per event are tested with Accept
+//   CASCADE   cascades are drawn from the level scheme conditioned on the
+//             filter (see G4CASCADE::SetFilter), so few are thrown away
+//
+// A filter is a comma-separated list of criteria, all of which must hold:
+//
+//   mult=N, mult=N-M, mult=N-   number of gammas
+//   esum=A-B, esum=A-           summed gamma energy in MeV, A < sum <= B
+//   line=E[/tol]                a gamma within tol of E MeV (default 2 keV)
+//   level=E[/tol]               an intermediate level within tol of E MeV,
+//                               from the Exfs branch for RAINIER
+//
+// line and level may be given more than once. -two-gamma-only is the
+// filter "mult=2,esum=5.4-". Cascades without gammas never pass.
+
+#ifndef CascadeFilter_h
+#define CascadeFilter_h 1
+
+#include "globals.hh"
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <vector>
+
+class CascadeFilter
+{
+  public:
+    static CascadeFilter* Instance();
+
+    static const char* const kTwoGammaOnly;
+    static const G4double kDefaultTolerance;
+
+    // Adds the criteria of spec; returns false, after printing the bad
+    // criterion, if spec cannot be parsed
+    G4bool Parse(const std::string& spec);
+
+    // True once any criterion was given
+    G4bool IsActive() const { return fActive; }
+
+    // True if a level criterion needs the intermediate levels of a cascade
+    G4bool NeedsLevels() const { return !fLevels.empty(); }
+
+    std::string GetDescription() const;
+
+    // One cascade: n gamma energies and nLevels intermediate level
+    // energies (MeV); levels may be null if !NeedsLevels(). Accept counts
+    // the cascade in the RAINIER acceptance report, Passes does not.
+    G4bool Accept(const G4double* energies, size_t n,
+                  const G4double* levels = nullptr, size_t nLevels = 0) const;
+    G4bool Passes(const G4double* energies, size_t n,
+                  const G4double* levels = nullptr, size_t nLevels = 0) const
+    { return FirstFailure(energies, n, levels, nLevels) == kNCriteria; }
+
+    // nCascades cascades stored back to back: cascade c has the gammas
+    // [offsets[c], offsets[c+1]) of energies and the levels
+    // [levelOffsets[c], levelOffsets[c+1]) of levels. Sets pass[c] and
+    // returns the number of cascades that pass.
+    G4long Evaluate(const G4double* energies, const G4long* offsets,
+                    const G4double* levels, const G4long* levelOffsets,
+                    G4long nCascades, std::vector<char>& pass) const;
+
+    // Criteria, for conditional sampling
+    struct Window {
+      G4double energy;
+      G4double tolerance;
+      G4bool Contains(G4double e) const { return std::abs(e - energy) <= tolerance; }
+    };
+    G4int GetMinMultiplicity() const { return fMinMultiplicity; }
+    G4int GetMaxMultiplicity() const { return fMaxMultiplicity; }   // -1: none
+    G4double GetMinSum() const { return fMinSum; }
+    G4double GetMaxSum() const { return fMaxSum; }
+    const std::vector<Window>& GetLines() const { return fLines; }
+    const std::vector<Window>& GetLevels() const { return fLevels; }
+
+    // Cascades drawn by conditional sampling: reachable is the probability
+    // that an unconditioned cascade passes the criteria the level scheme
+    // decides; retries are cascades drawn again because the rest failed
+    void RecordConditional(G4double reachable, G4long retries) const;
+
+    // Acceptance per source and criterion; silent if no filter was given
+    void PrintStatistics() const;
+
+  private:
+    CascadeFilter();
+    ~CascadeFilter();
+    CascadeFilter(const CascadeFilter&);
+    CascadeFilter& operator=(const CascadeFilter&);
+
+    enum Criterion { kEmpty, kMultiplicity, kSum, kLine, kLevel, kNCriteria };
+
+    // First criterion cascade fails, or kNCriteria if it passes
+    Criterion FirstFailure(const G4double* energies, size_t n,
+                           const G4double* levels, size_t nLevels) const;
+
+    G4bool fActive;
+    G4int fMinMultiplicity;
+    G4int fMaxMultiplicity;
+    G4double fMinSum;
+    G4double fMaxSum;
+    std::vector<Window> fLines;
+    std::vector<Window> fLevels;
+
+    // Counters for the end-of-run report
+    mutable std::atomic<G4long> fEvaluated;
+    mutable std::atomic<G4long> fRejected[kNCriteria];
+    mutable std::atomic<G4long> fConditional;
+    mutable std::atomic<G4long> fRetries;
+    mutable std::atomic<G4double> fReachable;
+};
+
+#endif
@@ -0,0 +1,27 @@
+// ==============================================================================
+// CascadeMessenger.hh - /cascade/ UI commands
+// ==============================================================================
+
+#ifndef CascadeMessenger_h
+#define CascadeMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithoutParameter;
+
+class CascadeMessenger : public G4UImessenger
+{
+public:
+    CascadeMessenger();
+    virtual ~CascadeMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+private:
+    G4UIdirectory* fCascadeDir;
+    G4UIcmdWithoutParameter* fListIsotopesCmd;
+};
+
+#endif
@@ -29,10 +29,17 @@ public:
     // Get detector angle
     G4double GetDetector2Angle() const { return fDetector2Angle; }
 
+    // Unit vector from the source towards detector 1 or 2, and the half
+    // angle of the cone that sees the collimator opening from the source
+    G4ThreeVector GetDetectorAxis(G4int detectorID) const;
+    G4double GetCollimatorHalfAngle() const;
+
 private:
     // Detector parameters
     static const G4double fSourceDetectorDistance;  // 10 cm
     static const G4double fWorldSize;              // 100 cm (increased for dual setup)
+    static const G4double fShieldStartDistance;    // 2.5 cm
+    static const G4double fTargetOpeningRadius;    // 1 cm
     G4double fDetector2Angle;                      // Angle for second detector (degrees)
 
     // Materials
@@ -0,0 +1,82 @@
+// ==============================================================================
+// EmissionBiasing.hh - Importance sampling of primary emission directions
+// ==============================================================================
+//
+// Only a few percent of isotropically emitted gammas leave the source
+// through a collimator opening; the rest are tracked into the lead or the
+// world. With -bias-cones f, in a fraction f of the events one primary,
+// chosen uniformly among the n of the event, is instead drawn uniformly
+// inside one of the two cones that see the collimator openings from the
+// source; every other direction stays isotropic. The density of the
+// directions u_1 ... u_n of an event, relative to isotropic emission, is
+// then the mixture
+//
+//   q / p = (1 - f) + (f / n) sum over primaries i of c(u_i)
+//
+// where c(u) = (number of cones holding u) * 4pi / (2 Omega), with
+// Omega = 2pi (1 - cos halfAngle) the solid angle of one cone, and the
+// event gets the weight p / q. Weighted spectra, counts and coincidences
+// have the same expectation as unbiased ones, and the weight never exceeds
+// 1 / (1 - f) (2 for f = 0.5) whatever the multiplicity. Biasing every
+// primary independently would weight an event with all n gammas outside
+// the cones by about 2^n, and a few heavy high-multiplicity events would
+// then dominate the variance. The isotropic share keeps gammas that reach a
+// crystal through the lead or by scattering in it.
+//
+// Configured once in main() from the DetectorConstruction, before any
+// thread exists; sampling uses the thread's own G4UniformRand engine.
+
+#ifndef EmissionBiasing_h
+#define EmissionBiasing_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+
+class EmissionBiasing
+{
+  public:
+    static EmissionBiasing* Instance();
+
+    static const G4double kDefaultFraction;
+
+    // Draws one direction inside the collimator cones of detector in a
+    // fraction (0 < fraction < 1) of the events
+    void Configure(G4double fraction, const DetectorConstruction& detector);
+
+    G4bool IsActive() const { return fFraction > 0.; }
+    G4double GetFraction() const { return fFraction; }
+    G4double GetHalfAngle() const { return fHalfAngle; }
+
+    // Primary of an event of nPrimaries to draw inside a cone: with
+    // probability f one chosen uniformly, else none (-1). Always -1 if
+    // biasing is off.
+    G4int ChooseBiasedPrimary(G4int nPrimaries) const;
+
+    // A direction drawn uniformly inside one of the cones, chosen uniformly
+    G4ThreeVector SampleConeDirection() const;
+
+    // Number of cones holding direction (a unit vector); the cones may
+    // overlap for small detector angles
+    G4int ConesHolding(const G4ThreeVector& direction) const;
+
+    // Weight of an event of nPrimaries whose directions lie in conesHeld
+    // cones in total (the sum of ConesHolding); 1 if biasing is off
+    G4double EventWeight(G4int conesHeld, G4int nPrimaries) const;
+
+    void PrintConfiguration() const;
+
+  private:
+    EmissionBiasing();
+
+    static const G4int kNumberOfCones = 2;
+
+    G4double fFraction;
+    G4double fHalfAngle;
+    G4double fCosHalfAngle;
+    G4double fConeWeight;                   // f 4pi / (2 Omega)
+    G4ThreeVector fAxes[kNumberOfCones];
+};
+
+#endif
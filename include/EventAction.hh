@@ -79,6 +79,9 @@ private:
     G4double fCoincidenceWindow;
     G4double fMinimumEnergy;
     
+    // Product of the weights of the primaries (1 unless -bias-cones)
+    G4double EventWeight(const G4Event* event) const;
+
     // Analysis methods
     void AnalyzeCoincidences();
     G4double CalculateAngleCorrelation(const GammaHit& hit1, const GammaHit& hit2);
@@ -7,7 +7,6 @@
 #include "Randomize.hh"
 #include "G4Gamma.hh"
 #include "G4Electron.hh"
-#include "G4RDAtomicDeexcitation.hh"
 #include <vector>
 #include <CLHEP/Units/SystemOfUnits.h>
 #include "G4SystemOfUnits.hh"
@@ -17,13 +16,19 @@
 #include <math.h>
 
 #include "G4RDAtomicDeexcitation.hh"
-#include "G4RDShellData.hh"
+#include "G4RDRelaxationTable.hh"
+#include "G4RDRelaxationChains.hh"
+#include "G4CASCADELevelCache.hh"
+#include "G4CASCADEBuffer.hh"
+#include "G4CASCADEConditional.hh"
 
 #include "G4PhotonEvaporation.hh"
 #include "G4IonTable.hh"
 
 using namespace std;
 
+class CascadeFilter;
+
 class G4CASCADE
 {
   public:
@@ -33,8 +38,79 @@ class G4CASCADE
     bool HasData(G4int Z, G4int A);
     vector<vector<vector<G4double>>> GetLevels(G4int Z, G4int A);
     G4ReactionProductVector* GetGammas(G4Fragment nucleus, G4bool UseRawExcitation, G4bool doUnplaced);
+
+    // Allocation-free variant: clears buffer and fills it with the cascade
+    // products in emission order; returns the number of particles
+    size_t GenerateCascade(const G4Fragment& nucleus, G4bool UseRawExcitation,
+                           G4bool doUnplaced, G4CASCADEBuffer& buffer);
     G4ThreeVector GetRandomDirection();
 
+    // Draw the X-rays after internal conversion as one complete relaxation
+    // chain from G4RDRelaxationChains instead of vacancy by vacancy
+    void SetTabulatedRelaxation(G4bool value) { fTabulatedRelaxation = value; }
+    G4bool GetTabulatedRelaxation() const { return fTabulatedRelaxation; }
+
+    // Draw only cascades that pass filter, from the conditional distribution
+    // (see G4CASCADEConditional); null draws every cascade
+    void SetFilter(const CascadeFilter* filter) { fFilter = filter; }
+
+    // Hands the level-cache hits counted since the last call to
+    // G4CASCADELevelCache; called at the end of each run
+    void FlushStatistics();
+
   private:
     G4String GetDataDirectory();
+
+    // Level graph shared through G4CASCADELevelCache, kept for the last isotope used
+    const G4CASCADELevelGraph* GetCachedLevels(G4int Z, G4int A);
+    const G4CASCADELevelGraph* fLevels;
+    G4int fLevelsZ;
+    G4int fLevelsA;
+    G4long fLevelHits;   // lookups served from fLevels, not yet flushed
+
+    // Q-value correction for UseRawExcitation, computed once per isotope
+    G4double GetQCorrection(const G4Fragment& nucleus);
+    G4bool fHasQCorrection;
+    G4double fQCorrection;
+
+    // Binding energies and radiative relaxation of the element, shared
+    // read-only by all threads, kept for the last Z used
+    const G4RDRelaxationTable* GetRelaxationTable(G4int Z);
+    const G4RDRelaxationTable* fRelaxation;
+    G4int fRelaxationZ;
+
+    // Whole-chain outcome tables of the K, L1 and M1 vacancies, kept for the last Z used
+    const G4RDRelaxationChains* GetRelaxationChains(G4int Z, G4int shell, G4int shellId);
+    G4bool fTabulatedRelaxation;
+    const G4RDRelaxationChains* fChains[3];
+    G4int fChainsZ[3];
+
+    // Photon evaporation engine for continuum levels, one per generator
+    // (i.e. per thread); the atomic deexcitation after internal conversion
+    // is stateless and shared. Product vectors are reused every event.
+    G4PhotonEvaporation* GetPhotonEvaporation();
+    std::vector<G4DynamicParticle*> fAtomicProducts;
+    G4PhotonEvaporation* fPhotonEvaporation;
+    G4FragmentVector fEvaporationProducts;
+
+    // One cascade, with branches drawn conditionally if conditional is set.
+    // Also fills the nuclear gamma energies and the intermediate levels
+    // (MeV) for the filter, and the probability that a cascade from the
+    // starting point passes what conditional decides.
+    size_t GenerateOne(const G4Fragment& nucleus, G4bool UseRawExcitation, G4bool doUnplaced,
+                       G4CASCADEBuffer& buffer, const G4CASCADEConditional* conditional);
+
+    // Conditional sampler for the cached level graph, rebuilt when the
+    // isotope or doUnplaced changes; null if the filter is too large for one
+    const G4CASCADEConditional* GetConditional(G4int Z, G4int A, G4bool doUnplaced);
+    const CascadeFilter* fFilter;
+    G4CASCADEConditional* fConditional;
+    std::vector<G4double> fNuclearGammas;
+    std::vector<G4double> fVisitedLevels;
+    G4double fReachable;
+    G4bool fConditionalWarned;
+
+    // Output of GenerateCascade behind the GetGammas wrapper
+    G4CASCADEBuffer fProductBuffer;
+    G4bool fOverflowWarned;
 };
@@ -0,0 +1,68 @@
+// ==============================================================================
+// G4CASCADEArchive.hh - Memory-mapped single-file CapGamData archive
+// ==============================================================================
+//
+// CapGamData.arc packs the level graphs of all isotopes into one file:
+//
+//   header   : magic "CGAMARC\0", uint32 version, uint32 number of isotopes
+//   index    : per isotope {int32 Z, int32 A, uint64 offset, uint64 size},
+//              sorted by (Z, A)
+//   blocks   : G4CASCADELevelGraph::Block() of every isotope, 8-byte aligned
+//
+// The file is mapped read-only, so the level graphs are used in place and
+// all worker threads share the same pages. Build() writes it from the
+// Z-A.bin files of a CapGamData directory (HPGeDual -build-archive).
+
+#ifndef G4CASCADEArchive_h
+#define G4CASCADEArchive_h 1
+
+#include "globals.hh"
+#include <cstddef>
+#include <cstdint>
+
+class G4CASCADEArchive
+{
+  public:
+    static const char* const kFileName;   // "CapGamData.arc"
+
+    G4CASCADEArchive();
+    ~G4CASCADEArchive();
+
+    // Maps the archive; returns false if it does not exist or is not valid
+    // (the latter with a warning, so the caller can fall back to .bin files)
+    G4bool Open(const G4String& path);
+    void Close();
+    G4bool IsOpen() const { return fData != nullptr; }
+
+    G4int NumberOfIsotopes() const { return (G4int)fNIsotopes; }
+    void GetIsotope(G4int index, G4int& Z, G4int& A) const;
+
+    G4bool Contains(G4int Z, G4int A) const { return FindEntry(Z, A) >= 0; }
+
+    // Level graph block of (Z, A) inside the mapping
+    G4bool Find(G4int Z, G4int A, const char*& block, size_t& size) const;
+
+    // Converts every Z-A.bin file of dataDir into an archive at outputPath.
+    // Returns the number of isotopes written, or -1 on error.
+    static G4int Build(const G4String& dataDir, const G4String& outputPath);
+
+  private:
+    G4CASCADEArchive(const G4CASCADEArchive&);
+    G4CASCADEArchive& operator=(const G4CASCADEArchive&);
+
+    struct IndexEntry {
+      int32_t Z;
+      int32_t A;
+      uint64_t offset;
+      uint64_t size;
+    };
+
+    G4int FindEntry(G4int Z, G4int A) const;
+
+    const char* fData;
+    size_t fSize;
+    uint32_t fNIsotopes;
+    const IndexEntry* fIndex;
+};
+
+#endif
@@ -0,0 +1,68 @@
+// ==============================================================================
+// G4CASCADEBuffer.hh - Caller-owned, fixed-capacity cascade output buffer
+// ==============================================================================
+//
+// G4CASCADE::GenerateCascade writes the particles of one cascade here instead
+// of allocating a G4ReactionProductVector. The storage is allocated once, in
+// the constructor, and reused for every event; keep one buffer per thread.
+
+#ifndef G4CASCADEBuffer_h
+#define G4CASCADEBuffer_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+class G4ParticleDefinition;
+
+struct G4CASCADEParticle
+{
+  const G4ParticleDefinition* definition;
+  G4double energy;            // kinetic energy
+  G4ThreeVector direction;    // unit vector
+  G4int order;                // cascade step that emitted it, from 1; conversion
+                              // electrons share the step with their X-rays
+};
+
+class G4CASCADEBuffer
+{
+  public:
+    static const size_t kDefaultCapacity = 256;
+
+    explicit G4CASCADEBuffer(size_t capacity = kDefaultCapacity)
+    : fParticles(capacity), fSize(0), fOverflowed(false) {}
+
+    void Clear() { fSize = 0; fOverflowed = false; }
+
+    size_t Size() const { return fSize; }
+    size_t Capacity() const { return fParticles.size(); }
+    G4bool Empty() const { return fSize == 0; }
+
+    // True if the last cascade had more particles than fit; the extra ones
+    // were dropped
+    G4bool Overflowed() const { return fOverflowed; }
+
+    const G4CASCADEParticle& operator[](size_t i) const { return fParticles[i]; }
+
+    G4bool Add(const G4ParticleDefinition* definition, G4double energy,
+               const G4ThreeVector& direction, G4int order)
+    {
+      if (fSize == fParticles.size()) {
+        fOverflowed = true;
+        return false;
+      }
+      G4CASCADEParticle& particle = fParticles[fSize++];
+      particle.definition = definition;
+      particle.energy = energy;
+      particle.direction = direction;
+      particle.order = order;
+      return true;
+    }
+
+  private:
+    std::vector<G4CASCADEParticle> fParticles;
+    size_t fSize;
+    G4bool fOverflowed;
+};
+
+#endif
@@ -0,0 +1,62 @@
+// ==============================================================================
+// G4CASCADECatalog.hh - Process-wide list of the available CapGam isotopes
+// ==============================================================================
+//
+// Resolves the CapGamData directory once (CAPGAM_DATA_DIR or the fallback
+// paths), maps CapGamData.arc if present and enumerates every (Z, A) with
+// level data. Isotope checks are then a lookup in a sorted list and cost
+// nothing per thread. Initialize() is called from main() so that a missing
+// data directory is reported before the run manager is created.
+
+#ifndef G4CASCADECatalog_h
+#define G4CASCADECatalog_h 1
+
+#include "globals.hh"
+#include "G4CASCADEArchive.hh"
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class G4CASCADECatalog
+{
+  public:
+    static G4CASCADECatalog* Instance();
+
+    // Resolves the directory and enumerates the isotopes on the first call;
+    // returns false if no data directory or no isotope was found
+    G4bool Initialize();
+
+    // Empty if no data directory was found
+    const G4String& GetDataDirectory();
+
+    // Mapped archive, or nullptr if the directory has none
+    const G4CASCADEArchive* GetArchive();
+
+    G4bool HasIsotope(G4int Z, G4int A);
+
+    // Available isotopes as (Z, A), sorted
+    const std::vector<std::pair<G4int, G4int>>& GetIsotopes();
+
+    // Energy of the capture state (the top level), the Sn to use with
+    // -cascade; 0 if the isotope has no data
+    G4double GetTopLevelEnergy(G4int Z, G4int A);
+
+    // Prints Z, A, top level energy and level count of every isotope
+    void ListIsotopes();
+
+  private:
+    G4CASCADECatalog();
+    ~G4CASCADECatalog();
+    G4CASCADECatalog(const G4CASCADECatalog&);
+    G4CASCADECatalog& operator=(const G4CASCADECatalog&);
+
+    void Load();
+    static G4String FindDataDirectory();
+
+    std::once_flag fLoaded;
+    G4String fDataDir;
+    G4CASCADEArchive fArchive;
+    std::vector<std::pair<G4int, G4int>> fIsotopes;
+};
+
+#endif
@@ -0,0 +1,86 @@
+// ==============================================================================
+// G4CASCADEConditional.hh - Cascade sampling conditioned on a CascadeFilter
+// ==============================================================================
+//
+// Drawing cascades and throwing away those that fail a filter wastes most
+// draws for a narrow filter. Because the level graph is a DAG, the
+// probability S(level, state) that a cascade continuing from level ends up
+// passing the filter can be computed in one pass from the ground state up,
+// where state holds what the filter has seen so far: the number of gammas
+// (capped just above the largest count that matters) and one bit per line
+// and level criterion already met. Choosing every branch with probability
+// proportional to weight * S(target, next state) then draws cascades from
+// exactly the conditional distribution, without rejection.
+//
+// The summed-energy window and whatever happens below a continuum level
+// (photon evaporation) are not decided by the level graph: S counts them as
+// passing, and G4CASCADE checks the finished cascade and draws again if
+// needed. That keeps the distribution exact, at the cost of a few redraws.
+// A filter that no cascade can pass (S = 0 at the capture state, or every
+// redraw failing) is a fatal error rather than a reason to hand out
+// cascades that fail it.
+
+#ifndef G4CASCADEConditional_h
+#define G4CASCADEConditional_h 1
+
+#include "globals.hh"
+#include "G4CASCADELevelGraph.hh"
+#include <vector>
+
+class CascadeFilter;
+
+class G4CASCADEConditional
+{
+  public:
+    // Largest table built, in states times levels
+    static const G4long kMaxTableSize = 1 << 26;
+
+    G4CASCADEConditional(const G4CASCADELevelGraph& graph, const CascadeFilter& filter,
+                         G4bool doUnplaced);
+    ~G4CASCADEConditional();
+
+    // False if the filter has too many criteria for a table
+    G4bool IsValid() const { return !fPass.empty(); }
+
+    const G4CASCADELevelGraph& GetGraph() const { return fGraph; }
+    G4bool GetDoUnplaced() const { return fDoUnplaced; }
+
+    // State of a cascade that has emitted nothing yet, and after a gamma of
+    // energy E that is not a transition of the graph (the excess gamma of
+    // UseRawExcitation)
+    G4int InitialState() const { return 0; }
+    G4int AfterGamma(G4int state, G4double E) const;
+
+    // Probability that a cascade at level in state passes the filter
+    G4double PassProbability(G4int level, G4int state) const
+    { return fPass[(size_t)level * fNStates + state]; }
+
+    // Branch out of level for the uniform deviate u, conditioned on passing;
+    // -1 if no branch may be followed or none can pass
+    G4int SampleTransition(G4int level, G4int state, G4double u) const;
+
+    // State after transition
+    G4int NextState(G4int state, G4int transition) const;
+
+  private:
+    // Whether a cascade that stops in state passes
+    G4bool Passes(G4int state) const;
+    G4int AddGamma(G4int state) const;
+
+    const G4CASCADELevelGraph& fGraph;
+    G4bool fDoUnplaced;
+
+    G4int fMinMultiplicity;
+    G4int fMaxMultiplicity;             // -1: none
+    G4int fCountCap;                    // counts above are not told apart
+    G4int fNBits;
+    G4int fAllBits;
+    G4int fNStates;                     // (fCountCap + 1) << fNBits
+
+    std::vector<G4double> fLineWindows; // energy, tolerance pairs (MeV)
+    std::vector<G4int> fTransitionBits; // line and target-level bits per transition
+    std::vector<G4int> fLevelBits;      // level bits per level
+    std::vector<G4double> fPass;        // S(level, state)
+};
+
+#endif
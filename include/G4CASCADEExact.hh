@@ -0,0 +1,83 @@
+// ==============================================================================
+// G4CASCADEExact.hh - Exact cascade probabilities from a CapGam level graph
+// ==============================================================================
+//
+// Transitions only go down in energy, so the level graph is a DAG and one
+// pass over the levels from the capture state down gives, per capture and
+// with the branch probabilities G4CASCADE samples from:
+//   - the probability that the cascade passes through each level,
+//   - the expected intensity of every gamma and conversion line,
+//   - the distribution of the number of gammas per cascade,
+//   - the probability that two gamma lines occur in the same cascade, and
+//   - the direct two-gamma cascades capture -> level -> ground.
+// Continuum levels (photon evaporation) are not followed: the population
+// that reaches them is reported as such and excluded from the multiplicity.
+
+#ifndef G4CASCADEExact_h
+#define G4CASCADEExact_h 1
+
+#include "globals.hh"
+#include "G4CASCADELevelGraph.hh"
+#include <iosfwd>
+#include <vector>
+
+class G4CASCADEExact
+{
+  public:
+    struct GammaPair {
+      G4int first;            // transition emitted first
+      G4int second;           // transition emitted later in the same cascade
+      G4double probability;   // per capture
+    };
+
+    struct TwoGammaCascade {
+      G4int level;            // intermediate level
+      G4int first;            // capture state -> level
+      G4int second;           // level -> ground
+      G4double probability;   // per capture
+    };
+
+    G4CASCADEExact(const G4CASCADELevelGraph& graph, G4bool doUnplaced = false);
+    ~G4CASCADEExact();
+
+    // Probability that the cascade passes through level
+    G4double Population(G4int level) const { return fPopulation[level]; }
+
+    // Expected number of emissions of transition per capture
+    G4double LineIntensity(G4int transition) const { return fIntensity[transition]; }
+
+    // Probability of the branch among the followed branches of its level
+    G4double BranchingRatio(G4int transition) const { return fBranching[transition]; }
+
+    // P(n gammas) for cascades that reach the ground state or a dead end
+    const std::vector<G4double>& MultiplicityDistribution() const { return fMultiplicity; }
+
+    // Population ending in continuum levels, or in levels with no followable branch
+    G4double ContinuumFraction() const { return fContinuumFraction; }
+    G4double DeadEndFraction() const { return fDeadEndFraction; }
+
+    // All ordered pairs of gamma lines in the same cascade with probability
+    // of at least threshold, most probable first
+    std::vector<GammaPair> GammaPairs(G4double threshold) const;
+
+    std::vector<TwoGammaCascade> TwoGammaCascades() const;
+
+    // Writes all of the above as a commented text table
+    void WriteTable(std::ostream& out, G4double pairThreshold) const;
+
+  private:
+    // Probability of passing through every level, starting at level start
+    void PropagateFrom(G4int start, std::vector<G4double>& reach) const;
+
+    const G4CASCADELevelGraph& fGraph;
+    G4bool fDoUnplaced;
+
+    std::vector<G4double> fBranching;
+    std::vector<G4double> fPopulation;
+    std::vector<G4double> fIntensity;
+    std::vector<G4double> fMultiplicity;
+    G4double fContinuumFraction;
+    G4double fDeadEndFraction;
+};
+
+#endif
@@ -0,0 +1,58 @@
+// ==============================================================================
+// G4CASCADELevelCache.hh - Process-wide cache of CapGam level schemes
+// ==============================================================================
+//
+// Every isotope's level graph is loaded at most once per process. If the data
+// directory holds a CapGamData.arc archive the graph is a view into the mapped
+// file; otherwise CapGamData/Z-A.bin is read and converted. Which isotopes
+// exist, and where, is decided by G4CASCADECatalog. The graph is
+// immutable and shared read-only by all worker threads; G4CASCADE keeps a
+// pointer to it instead of re-reading the file on every event.
+
+#ifndef G4CASCADELevelCache_h
+#define G4CASCADELevelCache_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include "G4CASCADELevelGraph.hh"
+#include <atomic>
+#include <map>
+#include <memory>
+
+class G4CASCADELevelCache
+{
+  public:
+    static G4CASCADELevelCache* Instance();
+
+    // Returns the level graph for (Z, A), reading it from disk on first use.
+    // Returns nullptr if no data exists for the isotope.
+    const G4CASCADELevelGraph* GetLevelGraph(G4int Z, G4int A);
+
+    // Adds lookups that were served from a caller-side copy of the pointer.
+    // Callers count them locally and hand them over at the end of a run, so
+    // workers do not share a counter on every event.
+    void RecordHits(G4long hits) { fHits.fetch_add(hits, std::memory_order_relaxed); }
+
+    G4long GetHits() const { return fHits.load(std::memory_order_relaxed); }
+    G4long GetMisses() const { return fMisses.load(std::memory_order_relaxed); }
+
+    void PrintStatistics() const;
+
+    // Reads a CapGamData .bin file; returns nullptr if it cannot be opened
+    static G4CASCADELevelScheme* ReadLevelFile(const G4String& fileName);
+
+  private:
+    G4CASCADELevelCache();
+    ~G4CASCADELevelCache();
+    G4CASCADELevelCache(const G4CASCADELevelCache&);
+    G4CASCADELevelCache& operator=(const G4CASCADELevelCache&);
+
+    // Key is 1000*Z + A; a null entry records an isotope without data
+    std::map<G4int, std::unique_ptr<const G4CASCADELevelGraph>> fGraphs;
+    G4Mutex fMutex;
+
+    std::atomic<G4long> fHits;
+    std::atomic<G4long> fMisses;
+};
+
+#endif
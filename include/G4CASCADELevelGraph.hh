@@ -0,0 +1,157 @@
+// ==============================================================================
+// G4CASCADELevelGraph.hh - Flat, index-based CapGam level scheme
+// ==============================================================================
+//
+// Compressed-sparse-row view of one isotope's level scheme. Levels are sorted
+// by energy with the ground state at index 0; the transitions of level i are
+// [FirstTransition(i), FirstTransition(i+1)) and point at their final level by
+// index, so walking a cascade needs no energy comparisons. Each level also
+// carries Walker alias tables of its branches, so a transition is chosen with
+// one uniform draw and one comparison. The graph is built and validated once,
+// when the isotope is loaded, and is immutable afterwards.
+//
+// All arrays live in one contiguous block (see Block()). A graph built from a
+// CapGamData .bin file owns its block; a graph read from the CapGamData.arc
+// archive points straight into the memory-mapped file.
+
+#ifndef G4CASCADELevelGraph_h
+#define G4CASCADELevelGraph_h 1
+
+#include "globals.hh"
+#include <cstddef>
+#include <vector>
+
+// Level scheme as stored in CapGamData: levels[c][0][0] is the level energy,
+// levels[c][t] (t >= 1) is {final level energy, probability, transition flag}
+typedef std::vector<std::vector<std::vector<G4double>>> G4CASCADELevelScheme;
+
+class G4CASCADELevelGraph
+{
+  public:
+    // Transition flags of the CapGam files in units of keV; negative values
+    // mark unplaced transitions, which are only followed with doUnplaced
+    enum TransitionType {
+      kUnknown    = 0,
+      kGamma      = 1,
+      kConversion = 2,
+      kContinuum  = 3
+    };
+
+    static const G4int kGround = 0;
+
+    // Builds the graph from a level scheme read from a .bin file
+    G4CASCADELevelGraph(G4int Z, G4int A, const G4CASCADELevelScheme& levels);
+
+    // Views a block written by Block(); the memory must outlive the graph.
+    // A truncated or inconsistent block gives a graph with !IsValid().
+    G4CASCADELevelGraph(G4int Z, G4int A, const char* block, size_t size);
+
+    ~G4CASCADELevelGraph();
+
+    G4bool IsValid() const { return fNLevels > 0; }
+
+    G4int GetZ() const { return fZ; }
+    G4int GetA() const { return fA; }
+
+    G4int NumberOfLevels() const { return fNLevels; }
+    G4int NumberOfTransitions() const { return fNTransitions; }
+    G4double LevelEnergy(G4int level) const { return fLevelEnergy[level]; }
+
+    // Capture state: the highest level of the scheme
+    G4int TopLevel() const { return fNLevels - 1; }
+
+    // Levels whose only transition has the -3 keV flag decay through
+    // G4PhotonEvaporation instead of the tabulated branches
+    G4bool IsContinuum(G4int level) const { return fContinuum[level] != 0; }
+
+    // Index of the highest level strictly below E (ground if none)
+    G4int HighestLevelBelow(G4double E) const;
+
+    G4int FirstTransition(G4int level) const { return fFirstTransition[level]; }
+    G4int Target(G4int transition) const { return fTarget[transition]; }
+    G4int Flag(G4int transition) const { return fFlag[transition]; }
+    G4double Probability(G4int transition) const { return fProbability[transition]; }
+
+    // Type with the placed/unplaced sign removed
+    TransitionType Type(G4int transition) const;
+
+    // Picks a transition out of level for the uniform deviate u, following
+    // only placed transitions unless doUnplaced. The probability of an
+    // unplaced transition that is not followed goes to the next followed
+    // transition of the level, as in the original cumulative scan.
+    // Returns -1 if the level has no transition that may be followed.
+    G4int SampleTransition(G4int level, G4bool doUnplaced, G4double u) const
+    {
+      const AliasTable& table = doUnplaced ? fAliasAll : fAliasPlaced;
+      G4int first = fFirstTransition[level];
+      G4int n = fFirstTransition[level+1] - first;
+      if (!table.followable[level]) return -1;
+
+      G4double x = u * n;
+      G4int i = (G4int)x;
+      if (i >= n) i = n - 1;
+      return (x - i < table.cut[first + i]) ? first + i : table.alias[first + i];
+    }
+
+    // Effective weight of a transition once skipped unplaced branches have
+    // been folded into the next followed one (not normalized)
+    G4double EffectiveWeight(G4int transition, G4bool doUnplaced) const
+    { return (doUnplaced ? fAliasAll : fAliasPlaced).weight[transition]; }
+
+    // Level scheme in the CapGamData layout, sorted by energy
+    G4CASCADELevelScheme ToLevelScheme() const;
+
+    // The flat arrays as one self-describing block, as stored in the archive
+    const char* Block() const { return fBlock; }
+    size_t BlockSize() const { return fBlockSize; }
+
+  private:
+    // Alias table of every level for one doUnplaced setting. Entries are
+    // indexed by transition; alias holds absolute transition indices.
+    struct AliasTable {
+      const G4double* weight;
+      const G4double* cut;
+      const G4int* alias;
+      const char* followable;   // per level
+    };
+
+    // Byte offsets of the arrays inside a block, each 8-byte aligned
+    struct Layout {
+      Layout(G4int nLevels, G4int nTransitions);
+      size_t levelEnergy, firstTransition, continuum;
+      size_t target, flag, probability;
+      size_t weight[2], cut[2], alias[2], followable[2];
+      size_t size;
+    };
+
+    void Attach(const char* block, size_t size);
+
+    static void BuildAliasTable(G4int nLevels, const G4int* firstTransition,
+                                const G4int* flag, const G4double* probability,
+                                G4bool doUnplaced, G4double* weight, G4double* cut,
+                                G4int* alias, char* followable);
+
+    G4int fZ;
+    G4int fA;
+    G4int fNLevels;
+    G4int fNTransitions;
+
+    std::vector<G4double> fOwnedBlock;   // empty for archive-backed graphs
+    const char* fBlock;
+    size_t fBlockSize;
+
+    const G4double* fLevelEnergy;
+    const G4int* fFirstTransition;       // NumberOfLevels() + 1 entries
+    const char* fContinuum;
+
+    const G4int* fTarget;
+    const G4int* fFlag;
+    const G4double* fProbability;
+
+    // One table for placed-only cascades and one for cascades that also
+    // follow unplaced transitions
+    AliasTable fAliasPlaced;
+    AliasTable fAliasAll;
+};
+
+#endif
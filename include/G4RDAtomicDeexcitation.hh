@@ -34,6 +34,9 @@
 // -----------
 //  
 //  16 Sept 2001  First committed to cvs
+//  16 Oct 2026   Radiative transitions sampled from G4RDRelaxationTable
+//  16 Oct 2026   Stateless: configuration fixed at construction, no
+//                per-call data members, so one instance can be shared
 //
 // -------------------------------------------------------------------
 
@@ -49,51 +52,66 @@
 #include "globals.hh"
 #include <vector>
 #include "G4DynamicParticle.hh"
+#include "G4RDRelaxationTable.hh"
+#include <CLHEP/Units/SystemOfUnits.h>
+
+// All generation methods are const and keep their state on the stack, so a
+// single instance may be used by any number of threads at once.
 
 class G4RDAtomicDeexcitation {
 
 public:
 
-  G4RDAtomicDeexcitation();
+  // Auger electron production and the production thresholds for
+  // fluorescence photons and Auger electrons; fixed for the lifetime
+  // of the object
+  explicit G4RDAtomicDeexcitation(G4bool augerProduction = false,
+                                  G4double cutForSecondaryPhotons = 100.*CLHEP::eV,
+                                  G4double cutForAugerElectrons = 100.*CLHEP::eV);
   ~G4RDAtomicDeexcitation();
   
   // Returns a vector contains the photons generated by radiative transitions
   // (non zero particles) or by non radiative transitions (zero particles)  
-  std::vector<G4DynamicParticle*>* GenerateParticles(G4int Z, G4int shellId);
+  std::vector<G4DynamicParticle*>* GenerateParticles(G4int Z, G4int shellId) const;
+
+  // Same, appending to a vector owned by the caller, which can reuse it;
+  // the caller owns (and deletes) the particles
+  void GenerateParticles(G4int Z, G4int shellId,
+                         std::vector<G4DynamicParticle*>& particles) const;
+
+  // Same, for a caller that already holds the relaxation table of the
+  // element (G4RDAtomicTransitionManager::RelaxationTable)
+  void GenerateParticles(const G4RDRelaxationTable& table, G4int shellId,
+                         std::vector<G4DynamicParticle*>& particles) const;
   
-  void SetCutForSecondaryPhotons(G4double cut);
-  // Set threshold energy for fluorescence 
+  G4double GetCutForSecondaryPhotons() const { return minGammaEnergy; }
+  // Threshold energy for fluorescence 
 
-  void SetCutForAugerElectrons(G4double cut);
-  // Set threshold energy for Auger electron production
+  G4double GetCutForAugerElectrons() const { return minElectronEnergy; }
+  // Threshold energy for Auger electron production
 
-  void ActivateAugerElectronProduction(G4bool val);
-  // Activate Auger electron production
+  G4bool IsAugerElectronProductionActive() const { return fAuger; }
+  // Whether Auger electrons are produced
 
 
 private:
   
   // Decides wether a radiative transition is possible and, if it is,
-  // returns the identity of the starting shell for the transition
-  G4int SelectTypeOfTransition(G4int Z, G4int shellId);
+  // returns the line of the table for the transition (-1 if not)
+  G4int SelectTypeOfTransition(const G4RDRelaxationTable& table, G4int shellId) const;
   
-  // Generates a particle from a radiative transition and returns it
-  G4DynamicParticle* GenerateFluorescence(G4int Z, G4int shellId,G4int provShellId);
+  // Generates a particle from a radiative transition and returns it;
+  // newShellId is set to the shell of the new vacancy
+  G4DynamicParticle* GenerateFluorescence(const G4RDRelaxationTable& table, G4int line,
+                                          G4int& newShellId) const;
  
-  // Generates a particle from a non-radiative transition and returns it
-  G4DynamicParticle* GenerateAuger(G4int Z, G4int shellId);
- 
-  // Data member which stores the shells to be filled by 
-  // the radiative transition
-  G4int newShellId;
-
-  G4double minGammaEnergy;
-  G4double minElectronEnergy;
-  G4bool   fAuger;
+  // Generates a particle from a non-radiative transition and returns it;
+  // newShellId is set to the shell of the new vacancy
+  G4DynamicParticle* GenerateAuger(G4int Z, G4int shellId, G4int& newShellId) const;
 
-  // Data member wich stores the id of the shell where is the vacancy 
-  // left from the Auger electron
-  G4int augerVacancyId;
+  const G4double minGammaEnergy;
+  const G4double minElectronEnergy;
+  const G4bool   fAuger;
  
 };
 
@@ -35,6 +35,9 @@
 //  
 //  16 Sept 2001 EG  Modified according to a design iteration in the 
 //                   LowEnergy category
+//  16 Oct 2026      Thread-safe Instance(); shell and transition tables
+//                   are loaded per element on first use
+//  16 Oct 2026      Flat per-element tables (RelaxationTable)
 //
 // -------------------------------------------------------------------
 
@@ -53,7 +56,11 @@
 #include "G4RDAugerData.hh"
 #include "G4RDFluoTransition.hh"
 #include "G4RDAtomicShell.hh"
+#include "G4RDRelaxationTable.hh"
+#include "G4Threading.hh"
 // #include "g4std/map"
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include "globals.hh"
 
@@ -63,12 +70,17 @@ class G4RDAtomicTransitionManager {
 public: 
 
   // The only way to get an instance of this class is to call the 
-  // function Instance() 
+  // function Instance(). It is safe to call from several threads; no data
+  // is read until an element is first asked for.
   static G4RDAtomicTransitionManager* Instance();
  
   // Z is the atomic number of the element, shellIndex is the 
   // index (in EADL) of the shell
   G4RDAtomicShell* Shell(G4int Z, size_t shellIndex) const;
+
+  // Shells and radiative transitions of the element in flat arrays, for
+  // lookups on the hot path; 0 if Z is outside the tables
+  const G4RDRelaxationTable* RelaxationTable(G4int Z) const;
    
   // Z is the atomic number of the element, shellIndex is the 
   // index (in EADL) of the final shell for the transition
@@ -119,19 +131,34 @@ private:
   G4RDAtomicTransitionManager& operator=(const G4RDAtomicTransitionManager& right);
   G4RDAtomicTransitionManager(const G4RDAtomicTransitionManager&);
  
-  static G4RDAtomicTransitionManager* instance;
-  
-  // the first element of the map is the atomic number Z.
-  // the second element is a vector of G4RDAtomicShell*.
-  std::map<G4int,std::vector<G4RDAtomicShell*>,std::less<G4int> > shellTable;
-  
-  // the first element of the map is the atomic number Z.
-  // the second element is a vector of G4AtomicTransition*.
-  std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> > transitionTable;
- 
-  // since Augereffect data r stored as a table in G4RDAugerData, we have here a pointer to an element of that class itself.
-
-  G4RDAugerData* augerData;
+  // Shells and radiative transitions of one element
+  struct ElementTables {
+    std::vector<G4RDAtomicShell*> shells;
+    std::vector<G4RDFluoTransition*> transitions;
+    G4bool hasTransitions;
+    G4RDRelaxationTable* relaxation;
+  };
+
+  // Returns the tables of Z, reading them from EADL on the first request.
+  // Loading is serialized; a table is published only once it is complete
+  // and is read-only afterwards, so lookups need no lock.
+  // Returns 0 if Z is outside [zMin, zMax].
+  const ElementTables* Element(G4int Z) const;
+
+  // Auger data are only needed with Auger emission switched on; the
+  // container is created on the first request and loads each element the
+  // first time it is asked for
+  G4RDAugerData* AugerData() const;
+
+  // Indexed by Z
+  mutable std::vector<std::atomic<const ElementTables*> > elementTables;
+  mutable G4Mutex elementMutex;
+
+  // Binding energies of all elements, read with the first element
+  mutable G4RDShellData* shellManager;
+
+  mutable G4RDAugerData* augerData;
+  mutable std::once_flag augerOnce;
 
   // Minimum and maximum Z in EADL table containing identities and binding
   // energies of shells
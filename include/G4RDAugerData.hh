@@ -31,6 +31,7 @@
 // History:
 // -----------
 //  2 June 2002 First committed to cvs
+//  16 Oct 2026 Elements loaded on first request, thread-safe
 //
 // -------------------------------------------------------------------
 
@@ -46,9 +47,12 @@
 #define G4RDAUGERDATA_HH 1
 
 #include "globals.hh"
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <map>
 #include "G4RDAugerTransition.hh"
+#include "G4Threading.hh"
 
 class G4DataVector;
 
@@ -94,8 +98,15 @@ public:
 
   std::vector<G4RDAugerTransition> LoadData(G4int Z);
 
+  // Loads the elements of the materials defined so far (all elements if
+  // there are none). Not needed for the accessors, which load on demand.
   void BuildAugerTransitionTable();
 
+  // Transitions of element Z, read on the first request for Z and shared
+  // read-only afterwards; safe to call from several threads. 0 if there
+  // are no Auger data for Z.
+  const std::vector<G4RDAugerTransition>* Transitions(G4int Z) const;
+
   void PrintData(G4int Z);
 
 
@@ -112,8 +123,12 @@ private:
 
   // std::map<G4int,G4DataVector*,std::less<G4int> > idMap;
 
-  typedef std::map<G4int,std::vector<G4RDAugerTransition>,std::less<G4int> > trans_Table;
-   trans_Table augerTransitionTable;
+  // EADL has Auger data for these elements
+  static const G4int minZ = 6;
+  static const G4int maxZ = 100;
+
+  // Indexed by Z; an entry is complete once loaded[Z] is set
+  std::vector<std::vector<G4RDAugerTransition> > augerTransitionTable;
 
   /*
   std::map<G4int,std::map<G4Int,G4DataVector*,std::less<G4int> >,std::less<G4int> > transProbabilityMap;
@@ -122,6 +137,9 @@ private:
 
   std::vector<G4int> nInitShells;
   std::vector<G4int> numberOfVacancies;
+
+  std::unique_ptr<std::atomic<bool>[]> loaded;
+  mutable G4Mutex loadMutex;
   
 };
 
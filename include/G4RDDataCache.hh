@@ -0,0 +1,108 @@
+// ==============================================================================
+// G4RDDataCache.hh - Memory-mapped binary cache of the EADL relaxation data
+// ==============================================================================
+//
+// G4RDShellData, G4RDFluoData and G4RDAugerData read whitespace-separated
+// numbers from $G4LEDATA/fluor and $G4LEDATA/auger. Build() parses those
+// files once and stores every number as a double:
+//
+//   header  : magic "G4RDEADL", uint32 version, uint32 number of files,
+//             uint64 checksum of the index, uint32 length of the G4LEDATA
+//             path, uint32 reserved, the path (padded to 8 bytes)
+//   index   : per file {char name[40], uint64 size, int64 mtime (ns),
+//             uint64 offset, uint64 number of values, uint64 checksum}
+//   values  : the numbers of every file, 8-byte aligned
+//
+// The cache is mapped read-only. It is only used if it was built from the
+// current G4LEDATA directory and every source file still has the size and
+// modification time recorded in the index; a file's values are checksummed
+// the first time they are read. Anything else falls back to the text files.
+//
+// The cache lives in $G4RD_DATA_CACHE if set, else in
+// $HOME/.cache/HPGeDual/G4LEDATA.cache (HPGeDual -build-eadl-cache).
+
+#ifndef G4RDDataCache_h
+#define G4RDDataCache_h 1
+
+#include "globals.hh"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+class G4RDDataCache
+{
+  public:
+    // Maps the cache on the first call; safe to call from any thread
+    static const G4RDDataCache* Instance();
+
+    G4bool IsOpen() const { return fData != nullptr; }
+
+    // Values of $G4LEDATA/<name> (e.g. "fluor/binding.dat"); false if the
+    // file is not in the cache or its values fail the checksum
+    G4bool Find(const G4String& name, const G4double*& values, size_t& count) const;
+
+    // Parses the relaxation data files of dataDir into a cache at
+    // outputPath. Returns the number of files written, or -1 on error.
+    static G4int Build(const G4String& dataDir, const G4String& outputPath);
+
+    static G4String DefaultPath();
+
+  private:
+    G4RDDataCache();
+    ~G4RDDataCache();
+    G4RDDataCache(const G4RDDataCache&);
+    G4RDDataCache& operator=(const G4RDDataCache&);
+
+    struct IndexEntry {
+      char name[40];
+      uint64_t size;
+      int64_t mtime;
+      uint64_t offset;
+      uint64_t count;
+      uint64_t checksum;
+    };
+
+    G4bool Open(const G4String& path, const G4String& dataDir);
+
+    const char* fData;
+    size_t fSize;
+    uint32_t fNFiles;
+    const IndexEntry* fIndex;
+
+    // Per file: 0 not yet checked, 1 checksum good, 2 checksum bad
+    std::unique_ptr<std::atomic<char>[]> fChecked;
+};
+
+// Reads the numbers of an EADL data file from the cache if it is there, or
+// else from the text file, with the interface the loaders used on std::ifstream
+class G4RDTokenStream
+{
+  public:
+    // name is relative to dataDir, e.g. "fluor/binding.dat"
+    G4RDTokenStream(const G4String& dataDir, const G4String& name);
+
+    G4bool is_open() const { return fValues != nullptr || fFile.is_open(); }
+
+    // Gives 0 past the end of the data, like std::ifstream
+    G4RDTokenStream& operator>>(G4double& value)
+    {
+      if (fValues) {
+        value = (fNext < fCount) ? fValues[fNext++] : 0.;
+      } else {
+        fFile >> value;
+      }
+      return *this;
+    }
+
+    void close() { fFile.close(); fValues = nullptr; }
+
+  private:
+    const G4double* fValues;
+    size_t fCount;
+    size_t fNext;
+    std::ifstream fFile;
+};
+
+#endif
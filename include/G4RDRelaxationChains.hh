@@ -0,0 +1,74 @@
+// ==============================================================================
+// G4RDRelaxationChains.hh - Complete radiative relaxation outcomes of a vacancy
+// ==============================================================================
+//
+// With Auger emission off, G4RDAtomicDeexcitation fills a vacancy step by
+// step: each step either emits a fluorescence photon and moves the vacancy
+// to an outer shell, or ends the chain (non-radiative). For one element and
+// initial shell there are only a few possible chains, so this class lists
+// every complete outcome (the sequence of photon energies) with its
+// probability and draws one with a single alias-table lookup. The
+// distribution is exactly that of the stepwise sampler.
+//
+// Tables are built on first use per (Z, shell) by Get() and shared
+// read-only by all threads.
+
+#ifndef G4RDRelaxationChains_h
+#define G4RDRelaxationChains_h 1
+
+#include "globals.hh"
+#include "G4RDRelaxationTable.hh"
+#include <vector>
+
+class G4RDRelaxationChains
+{
+  public:
+    // Outcome table of a vacancy in shellId of element Z, built on the first
+    // call; 0 if Z has no relaxation data. Safe to call from any thread.
+    static const G4RDRelaxationChains* Get(G4int Z, G4int shellId);
+
+    G4RDRelaxationChains(const G4RDRelaxationTable& table, G4int shellId);
+    ~G4RDRelaxationChains();
+
+    G4int GetZ() const { return fZ; }
+    G4int GetShellId() const { return fShellId; }
+
+    // False if the chains were too many to list; use the stepwise sampler
+    G4bool IsComplete() const { return fComplete; }
+
+    G4int NumberOfOutcomes() const { return (G4int)fProbability.size(); }
+    G4double Probability(G4int outcome) const { return fProbability[outcome]; }
+
+    // Photons of an outcome, in emission order
+    G4int NumberOfPhotons(G4int outcome) const
+    { return fFirstPhoton[outcome+1] - fFirstPhoton[outcome]; }
+    G4double PhotonEnergy(G4int outcome, G4int i) const
+    { return fPhotonEnergy[fFirstPhoton[outcome] + i]; }
+
+    // Outcome for the uniform deviate u
+    G4int Sample(G4double u) const
+    {
+      G4int n = NumberOfOutcomes();
+      G4double x = u * n;
+      G4int i = (G4int)x;
+      if (i >= n) i = n - 1;
+      return (x - i < fCut[i]) ? i : fAlias[i];
+    }
+
+  private:
+    void Enumerate(const G4RDRelaxationTable& table, G4int shellId, G4double probability,
+                   std::vector<G4double>& photons);
+    void BuildAliasTable();
+
+    G4int fZ;
+    G4int fShellId;
+    G4bool fComplete;
+
+    std::vector<G4double> fProbability;
+    std::vector<G4int> fFirstPhoton;      // NumberOfOutcomes() + 1 entries
+    std::vector<G4double> fPhotonEnergy;
+    std::vector<G4double> fCut;
+    std::vector<G4int> fAlias;
+};
+
+#endif
@@ -0,0 +1,79 @@
+// ==============================================================================
+// G4RDRelaxationTable.hh - Flat radiative relaxation table of one element
+// ==============================================================================
+//
+// The shells and fluorescence transitions of one element, as read from EADL
+// by G4RDAtomicTransitionManager, in contiguous arrays. A vacancy is looked
+// up by shell id with one array read, and the radiative line filling it is
+// picked from precomputed cumulative probabilities, so that one
+// vacancy-filling step does not walk the G4RDFluoTransition objects.
+// Built once per element by G4RDAtomicTransitionManager and read-only
+// afterwards.
+
+#ifndef G4RDRelaxationTable_h
+#define G4RDRelaxationTable_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class G4RDAtomicShell;
+class G4RDFluoTransition;
+
+class G4RDRelaxationTable
+{
+  public:
+    G4RDRelaxationTable(G4int Z, const std::vector<G4RDAtomicShell*>& shells,
+                        const std::vector<G4RDFluoTransition*>& transitions);
+    ~G4RDRelaxationTable();
+
+    G4int GetZ() const { return fZ; }
+
+    // Shells in EADL order
+    G4int NumberOfShells() const { return (G4int)fShellId.size(); }
+    G4int ShellId(G4int shellIndex) const { return fShellId[shellIndex]; }
+    G4double BindingEnergy(G4int shellIndex) const
+    { return (shellIndex >= 0 && shellIndex < NumberOfShells()) ? fBindingEnergy[shellIndex] : 0.; }
+
+    // Vacancies that can be filled by a radiative transition
+    G4int NumberOfVacancies() const { return (G4int)fFirstLine.size() - 1; }
+
+    // Vacancy filled by the lines of shellId, or -1 if a vacancy in shellId
+    // can only relax non-radiatively. As in G4RDAtomicDeexcitation, a shell
+    // id below the last radiative vacancy that has no entry of its own uses
+    // the last vacancy.
+    G4int Vacancy(G4int shellId) const
+    { return (shellId > 0 && shellId < (G4int)fVacancyOfShellId.size()) ? fVacancyOfShellId[shellId] : -1; }
+
+    // Lines of vacancy v are [FirstLine(v), FirstLine(v+1))
+    G4int FirstLine(G4int vacancy) const { return fFirstLine[vacancy]; }
+    G4int OriginatingShellId(G4int line) const { return fLines[line].shellId; }
+    G4double LineEnergy(G4int line) const { return fLines[line].energy; }
+    G4double CumulativeProbability(G4int line) const { return fLines[line].cumulative; }
+
+    // Radiative line filling vacancy for the uniform deviate u, or -1 if u
+    // falls in the non-radiative (Auger) remainder
+    G4int SampleLine(G4int vacancy, G4double u) const
+    {
+      G4int last = fFirstLine[vacancy+1];
+      for (G4int line = fFirstLine[vacancy]; line < last; line++) {
+        if (u <= fLines[line].cumulative) return line;
+      }
+      return -1;
+    }
+
+  private:
+    struct Line {
+      G4double cumulative;   // sum of the probabilities up to this line
+      G4double energy;
+      G4int shellId;         // shell of the electron, i.e. the new vacancy
+    };
+
+    G4int fZ;
+    std::vector<G4int> fShellId;
+    std::vector<G4double> fBindingEnergy;
+    std::vector<G4int> fVacancyOfShellId;
+    std::vector<G4int> fFirstLine;          // NumberOfVacancies() + 1 entries
+    std::vector<Line> fLines;
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "G4ParticleGun.hh"
 #include "globals.hh"
 #include "G4CASCADE.hh"
+#include "CascadeBlockBuffer.hh"
 #include "G4Fragment.hh"
 #include <string>
 #include <vector>
@@ -19,6 +20,7 @@
 
 class G4ParticleGun;
 class G4Event;
+class RAINIERCascadeStore;
 
 // Enhanced structure for gamma cascade data
 struct GammaData {
@@ -29,13 +31,6 @@ struct GammaData {
     int sequenceOrder;  // Order in cascade (1st, 2nd, etc.)
 };
 
-// Structure for complete cascade sequences
-struct CascadeData {
-    std::vector<GammaData> gammas;
-    double totalIntensity;
-    std::string cascadeName;
-};
-
 // Structure for two-gamma pairs (Sn -> intermediate -> ground)
 struct TwoGammaPair {
     double gamma1;              // First gamma energy (MeV): Sn - E_intermediate
@@ -57,26 +52,33 @@ enum SourceMode {
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
 public:
+    // With rainierStore, RAINIER cascades are taken from the preloaded
+    // store (a ROOT file read with -rainier-preload, or a text cascade
+    // list) instead of this action's own TChain
     PrimaryGeneratorAction(const std::string& rainierFile = "", bool generateCascades = true,
-                           SourceMode initialMode = CO60_CASCADE);
+                           SourceMode initialMode = CO60_CASCADE,
+                           const RAINIERCascadeStore* rainierStore = nullptr);
     virtual ~PrimaryGeneratorAction();
 
     virtual void GeneratePrimaries(G4Event*);
 
     const G4ParticleGun* GetParticleGun() const { return fParticleGun; }
 
+    // Hands this thread's CASCADE level-cache hits to the shared counters
+    // (see G4CASCADE::FlushStatistics); called by RunAction at end of run
+    void FlushStatistics() const { if (fCascadeGenerator) fCascadeGenerator->FlushStatistics(); }
+
     // CASCADE mode configuration
     void SetSourceMode(SourceMode mode);
     void SetIsotope(G4int Z, G4int A) { fIsotopeZ = Z; fIsotopeA = A; }
     void SetExcitationEnergy(G4double E) { fExcitationEnergy = E; }
     void SetCascadePosition(G4ThreeVector pos) { fCascadePosition = pos; }
-    void SetTwoGammaOnly(bool flag) { fTwoGammaOnly = flag; }
+    void SetCascadeBlockSize(G4int n) { fCascadeBlock.SetBlockSize(n); }
+    void SetTabulatedRelaxation(bool flag) { fCascadeGenerator->SetTabulatedRelaxation(flag); }
 
 private:
     G4ParticleGun* fParticleGun;
     std::string fRAINIERFile;
-    std::vector<GammaData> fGammaData;        // Individual gammas (legacy)
-    std::vector<CascadeData> fCascadeData;    // Complete cascades
     std::mt19937 fRandomGenerator;
     bool fGenerateCascades;                   // Flag for cascade mode
 
@@ -88,24 +90,53 @@ private:
     G4CASCADE* fCascadeGenerator;
     G4ThreeVector fCascadePosition;           // Where cascade occurs
 
-    // RAINIER ROOT file members
-    class TFile* fRAINIERRootFile;            // ROOT file handle
-    class TTree* fRAINIERTree;                // ROOT tree
-    std::vector<Double_t>* fRAINIEREgs;       // Gamma energies from RAINIER
-    std::vector<Double_t>* fRAINIERExfs;      // Final excitation energies
-    Long64_t fRAINIERCurrentEntry;            // Current entry in ROOT tree
-    Long64_t fRAINIERTotalEntries;            // Total entries in tree
+    // RAINIER ROOT file members: one TChain per range of RAINIERFileList,
+    // opened when this thread first takes a chunk from that range
+    struct RAINIERChain {
+        class TTree* tree;                    // TChain of the files of the range
+        std::vector<Double_t>* egs;           // Gamma energies from RAINIER
+        std::vector<Double_t>* exfs;          // Levels reached, read only for a level criterion
+        Long64_t offset;                      // Global index of the chain's first entry
+    };
+    std::vector<RAINIERChain*> fRAINIERChains; // Empty until the files are initialized
+    G4int fRAINIERHomeRange;                  // Range this thread reads first
+    Long64_t fRAINIERCurrentEntry;            // Next position in the current chunk
+    Long64_t fRAINIERChunkEnd;                // End of that chunk
+    Long64_t fRAINIERChunkFirst;              // Its first position (file chunks only)
+    G4int fRAINIERChunkRange;                 // Its range, -1 if none is held
+    Long64_t fRAINIERChunkPass;               // Its pass over the sequence
+    G4bool fRAINIERChunkAccepted;             // Whether it held an accepted cascade
+    G4bool fRAINIERExhausted;                 // No range holds an accepted cascade
+    Long64_t fRAINIERTotalEntries;            // Total entries in all files (accepted ones if indexed)
     Long64_t fRAINIEREmptyCount;              // Count of empty cascades skipped
-    bool fTwoGammaOnly;                       // Only allow 2-gamma cascades
+    const RAINIERCascadeStore* fRAINIERStore; // Preloaded cascades (shared, not owned)
+    class RAINIERSampler* fRAINIERSampler;    // This thread's random order of them, if any
+    const G4double* fRAINIERCascade;          // Energies (MeV) of the current cascade
+    size_t fRAINIERCascadeSize;               // Number of gammas in it
+    class RAINIERStreamReader* fRAINIERStream; // Reader thread started by main(), if any
+    std::vector<G4double> fRAINIERStreamCascade; // Cascade taken from the stream
+
+    // CASCADE_DIRECT state: cascades are generated in blocks and handed out
+    // one per event
+    CascadeBlockBuffer fCascadeBlock;         // Pre-generated cascades (SoA)
+    G4Fragment fCascadeNucleus;               // Excited nucleus for fIsotopeZ/A
+    G4int fCascadeNucleusZ;
+    G4int fCascadeNucleusA;
+    G4double fCascadeNucleusEx;
 
     // Methods for cascade handling
     GammaData SampleGamma();                  // Sample individual gamma (legacy)
-    void InitializeRAINIERFile();             // Open and setup RAINIER ROOT file
-    bool GetNextRAINIERCascade();             // Read next valid cascade from file
-
-    // Position and direction sampling
+    void InitializeRAINIERFile();             // Open and setup this thread's RAINIER files
+    RAINIERChain* OpenRAINIERChain(G4int range); // Chain of the files of a range
+    bool GetNextRAINIERCascade();             // Read next valid cascade from file or store
+    Long64_t NextRAINIERPosition();           // Next position from the shared cursor (-1 on error)
+
+    // Position and direction sampling. With -bias-cones (see EmissionBiasing)
+    // the direction is drawn inside a cone if inCone, and conesHeld counts
+    // the cones holding the directions of the event for its weight.
     G4ThreeVector SampleSourcePosition();
-    G4ThreeVector SampleDirection();
+    G4ThreeVector SampleDirection(G4bool inCone, G4int& conesHeld);
+    void SetEventWeight(G4Event* anEvent, G4int conesHeld, G4int nPrimaries);
 
     // Cascade generation methods
     void GenerateSingleGammaEvent(G4Event* anEvent);
@@ -0,0 +1,96 @@
+// ==============================================================================
+// RAINIERCascadeStore.hh - RAINIER cascades preloaded into one flat buffer
+// ==============================================================================
+//
+// With -rainier-preload, main() reads the Egs branch of the RAINIER tree
+// once, keeps only the cascades that pass the CascadeFilter, and stores
+// their gamma energies back to back with an offsets array. Entries are read
+// in batches that the filter evaluates in one go, and Exfs is only read if a
+// level criterion needs it. The store is read-only after loading and every
+// worker's PrimaryGeneratorAction uses it through a pointer, so a cascade
+// costs no I/O and memory does not grow with the number of threads.
+//
+// A text cascade list (.txt or .dat, see RAINIERTextReader) is always
+// loaded into a store. Its cascades may carry intensities; if they are not
+// all equal the store builds a Walker alias table and cascades are drawn in
+// proportion to their intensity in O(1) instead of being taken in order.
+
+#ifndef RAINIERCascadeStore_h
+#define RAINIERCascadeStore_h 1
+
+#include "globals.hh"
+#include <string>
+#include <vector>
+
+class CascadeFilter;
+
+class RAINIERCascadeStore
+{
+  public:
+    // Cascades handed to the filter at a time
+    static const G4long kBatchSize = 4096;
+
+    // Reads all cascades of the tree treeName in files that pass filter, in
+    // order; returns nullptr (after printing the reason) if none passes.
+    // With entries (global entry numbers from RAINIERIndex) only those are
+    // read, and taken as accepted.
+    static RAINIERCascadeStore* Load(const std::vector<std::string>& files,
+                                     const std::string& treeName, const CascadeFilter& filter,
+                                     const std::vector<G4long>* entries = nullptr);
+
+    // Reads all cascades of the text cascade list fileName that pass filter;
+    // returns nullptr (after printing the reason) if the file cannot be read
+    // or none passes. Text lists carry no levels.
+    static RAINIERCascadeStore* LoadText(const std::string& fileName, const CascadeFilter& filter);
+
+    G4long GetNumberOfCascades() const { return (G4long)fOffsets.size() - 1; }
+    G4long GetNumberOfGammas() const { return (G4long)fEnergies.size(); }
+    G4long GetEntriesRead() const { return fEntriesRead; }
+
+    // Gamma energies (MeV) of a cascade
+    const G4double* Energies(G4long cascade) const { return fEnergies.data() + fOffsets[cascade]; }
+    size_t NumberOfGammas(G4long cascade) const
+    { return (size_t)(fOffsets[cascade+1] - fOffsets[cascade]); }
+
+    // True if the cascades have unequal intensities and are drawn with Sample
+    G4bool IsWeighted() const { return !fCut.empty(); }
+
+    // Cascade for the uniform deviate u, drawn in proportion to its intensity
+    G4long Sample(G4double u) const
+    {
+      G4long n = GetNumberOfCascades();
+      G4double x = u * n;
+      G4long i = (G4long)x;
+      if (i >= n) i = n - 1;
+      return (x - i < fCut[i]) ? i : fAlias[i];
+    }
+
+    // Bytes held by the store
+    size_t MemoryUsage() const
+    {
+      return fEnergies.capacity() * sizeof(G4double) + fOffsets.capacity() * sizeof(G4long)
+           + fCut.capacity() * sizeof(G4double) + fAlias.capacity() * sizeof(G4long);
+    }
+
+  private:
+    RAINIERCascadeStore();
+
+    // Cascades read but not yet filtered
+    struct Batch;
+
+    // Evaluates batch with filter, appends the cascades that pass (and their
+    // intensities, if given) and empties it
+    void AddBatch(const CascadeFilter& filter, Batch& batch, std::vector<G4double>* intensities);
+
+    // Alias table over intensities, one per cascade; left empty if they
+    // are all equal
+    void BuildAliasTable(const std::vector<G4double>& intensities);
+
+    std::vector<G4double> fEnergies;
+    std::vector<G4long> fOffsets;      // GetNumberOfCascades() + 1 entries
+    std::vector<G4double> fCut;        // alias table, empty if unweighted
+    std::vector<G4long> fAlias;
+    G4long fEntriesRead;
+};
+
+#endif
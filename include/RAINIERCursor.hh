@@ -0,0 +1,76 @@
+// ==============================================================================
+// RAINIERCursor.hh - Process-wide hand-out of RAINIER tree entries
+// ==============================================================================
+//
+// Preloaded RAINIER cascades are not replayed per thread: workers take
+// chunks of consecutive entries from one shared atomic cursor, so each
+// cascade is used once before any is reused. When the cursor passes the
+// last entry it wraps to the first one; that is counted and reported at
+// the end of the run together with the number of distinct cascades used.
+// Workers reading chunks of the files (RAINIERFileList) or drawing their
+// own order of preloaded cascades (RAINIERSampler), and the stream reader,
+// record the entries they use here for the same report.
+
+#ifndef RAINIERCursor_h
+#define RAINIERCursor_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+class RAINIERCursor
+{
+  public:
+    static RAINIERCursor* Instance();
+
+    // Entries handed out at a time: large enough that workers rarely
+    // touch the shared cursor, small enough to keep the threads balanced
+    static const G4long kDefaultChunkSize = 256;
+
+    // Declares the number of entries of the tree; called by every worker
+    // when it opens the file. Returns false if a worker sees a different
+    // number than the first one did.
+    G4bool Attach(G4long totalEntries);
+
+    G4long GetTotalEntries() const { return fTotalEntries.load(std::memory_order_acquire); }
+
+    // Takes the next chunk: positions [first, first + kDefaultChunkSize) of
+    // the endless sequence 0, 1, ..., N-1, 0, 1, ...; the entry at position
+    // p is p % N. Returns false before Attach().
+    G4bool NextChunk(G4long& first, G4long& end);
+
+    // Records that the entry at a position was used for an event, or that
+    // one was skipped (empty or rejected by the CascadeFilter)
+    void RecordUsed(G4long position);
+    void RecordSkipped() { fSkipped.fetch_add(1, std::memory_order_relaxed); }
+
+    G4long GetCascadesUsed() const { return fUsed.load(std::memory_order_relaxed); }
+    G4long GetUniqueCascades() const;
+    G4long GetSkipped() const { return fSkipped.load(std::memory_order_relaxed); }
+    G4long GetWraparounds() const;
+
+    // Summary at the end of the run; silent if no entry was used or skipped
+    void PrintStatistics() const;
+
+  private:
+    RAINIERCursor();
+    ~RAINIERCursor();
+    RAINIERCursor(const RAINIERCursor&);
+    RAINIERCursor& operator=(const RAINIERCursor&);
+
+    G4Mutex fMutex;
+    std::atomic<G4long> fTotalEntries;
+    std::atomic<G4long> fNext;
+
+    // One bit per entry, set when the entry is used
+    std::unique_ptr<std::atomic<std::uint64_t>[]> fUsedBits;
+    G4long fNumberOfWords;
+
+    std::atomic<G4long> fUsed;
+    std::atomic<G4long> fSkipped;
+    std::atomic<G4long> fPass;     // highest pass over the tree that was used
+};
+
+#endif
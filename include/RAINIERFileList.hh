@@ -0,0 +1,127 @@
+// ==============================================================================
+// RAINIERFileList.hh - The RAINIER files of a run and their split by thread
+// ==============================================================================
+//
+// The -RAINIER argument may be one ROOT file, a glob such as
+// "out/Run*.root" (quote it for the shell), or a list file (.list or
+// .txt) with one path or glob per line; blank lines and lines starting
+// with '#' are ignored, and relative paths are taken relative to the
+// list file. main() expands it and opens every file once before the run
+// to check the tree and count its entries, so that a missing or damaged
+// file stops the program before beamOn.
+//
+// The files are then seen as one sequence of entries, which is cut into
+// one contiguous range per worker thread. Each worker reads its entries in
+// chunks from its own range, through a TChain of the files that overlap
+// it, so that as a rule no basket is decompressed by two threads. A worker
+// whose range has been handed out for the current pass takes its chunks
+// from the ranges that are behind instead of reading its own again, so
+// every entry is used once before any is used again and a pass over the
+// sequence ends at the same time for all ranges. A range in which a whole
+// pass finds no cascade that the CascadeFilter accepts is left out from
+// then on.
+//
+// With -rainier-index (see RAINIERIndex) the sequence holds only the
+// entries the CascadeFilter accepts: positions in it are mapped to entry
+// numbers with GetEntry, and the number of distinct cascades is known
+// before beamOn.
+
+#ifndef RAINIERFileList_h
+#define RAINIERFileList_h 1
+
+#include "globals.hh"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CascadeFilter;
+
+class RAINIERFileList
+{
+  public:
+    static RAINIERFileList* Instance();
+
+    static const char* const kDefaultTreeName;
+
+    // Expands spec into files and checks each one: it must open, hold the
+    // tree treeName with an Egs branch (and Exfs if the CascadeFilter has a
+    // level criterion), and have at least one entry.
+    // Prints the files with their entry counts unless in quiet mode.
+    // Returns false, after printing every bad file, if any check fails.
+    G4bool Open(const std::string& spec, const std::string& treeName = kDefaultTreeName);
+
+    // Reads or builds the index of every file for filter and restricts the
+    // sequence to the accepted entries. Returns false (after printing the
+    // reason) if an index cannot be built or no entry is accepted.
+    G4bool LoadIndex(const CascadeFilter& filter);
+
+    // Cuts the sequence into nThreads contiguous ranges (1 for sequential runs)
+    void Assign(G4int nThreads);
+
+    G4bool IsOpen() const { return !fFiles.empty(); }
+    G4bool HasIndex() const { return fIndexed; }
+    const std::string& GetTreeName() const { return fTreeName; }
+    const std::vector<std::string>& GetFiles() const { return fFiles; }
+    G4long GetTotalEntries() const { return fFirstEntry.empty() ? 0 : fFirstEntry.back(); }
+
+    // Length of the sequence: the accepted entries if indexed, else all
+    G4long GetSize() const { return fIndexed ? (G4long)fAccepted.size() : GetTotalEntries(); }
+
+    // Global entry number at position of the sequence
+    G4long GetEntry(G4long position) const { return fIndexed ? fAccepted[position] : position; }
+    const std::vector<G4long>& GetAcceptedEntries() const { return fAccepted; }
+
+    // Range read first by thread (the G4Threading thread id; -1 for the
+    // master or a sequential run), and the positions [first, end) of a range
+    G4int GetNumberOfRanges() const { return fNumberOfRanges; }
+    G4int GetHomeRange(G4int thread) const { return thread < 0 ? 0 : thread % fNumberOfRanges; }
+    void GetRange(G4int range, G4long& first, G4long& end) const;
+
+    // Takes the next chunk of positions [first, end) of range, in pass over
+    // the sequence: from home while no other range is a pass behind it,
+    // else from the range furthest behind. Returns false once every range
+    // has been found to hold no accepted cascade.
+    G4bool NextChunk(G4int home, G4int& range, G4long& first, G4long& end, G4long& pass);
+
+    // Reports a chunk from NextChunk as read, and whether any of its
+    // entries was accepted
+    void ChunkDone(G4int range, G4long pass, G4long size, G4bool accepted);
+
+    // Files holding positions [first, end) in order, and the global entry
+    // number of the first entry of the first of them
+    std::vector<std::string> FilesInRange(G4long first, G4long end, G4long& offset) const;
+
+  private:
+    RAINIERFileList();
+    ~RAINIERFileList();
+    RAINIERFileList(const RAINIERFileList&);
+    RAINIERFileList& operator=(const RAINIERFileList&);
+
+    // Paths named by spec; empty if a glob matches nothing
+    static std::vector<std::string> Expand(const std::string& spec);
+
+    // Cuts the sequence into n ranges and resets their hand-out
+    void SetRanges(G4int n);
+
+    // Hand-out state of one range: positions taken over all passes, entries
+    // of the first pass read, and what was found in them
+    struct Range {
+      G4long first;
+      G4long size;
+      std::atomic<G4long> taken;
+      std::atomic<G4long> firstPassRead;
+      std::atomic<bool> accepted;
+      std::atomic<bool> empty;
+    };
+
+    std::string fTreeName;
+    std::vector<std::string> fFiles;
+    std::vector<G4long> fFirstEntry;   // fFiles.size() + 1 entries
+    G4bool fIndexed;
+    std::vector<G4long> fAccepted;     // global entry numbers, if indexed
+    G4int fNumberOfRanges;
+    std::unique_ptr<Range[]> fRanges;
+};
+
+#endif
@@ -0,0 +1,85 @@
+// ==============================================================================
+// RAINIERIndex.hh - Sidecar index of the RAINIER entries a filter accepts
+// ==============================================================================
+//
+// With a filter such as -two-gamma-only most RAINIER entries are rejected,
+// and every run used to read and reject them again. With -rainier-index the
+// entries of each file that pass the CascadeFilter are found once and kept
+// next to the file, in <file>.<key>.idx, where key is a hash of the tree
+// name and the filter description, so indexes of several filters coexist:
+//
+//   header  : magic "RAINIDX1", uint32 version, uint32 number of
+//             multiplicity bins, uint32 number of sum bins, uint32 length
+//             of the key text, uint64 size of the ROOT file, uint64
+//             checksum of the ROOT file, int64 entries in the tree, int64
+//             entries accepted, double sum bin width (MeV), uint64
+//             checksum of the sections below, the key text ("tree\nfilter",
+//             padded to 8 bytes)
+//   counts  : uint64 per multiplicity bin and per summed-energy bin of the
+//             accepted cascades; the last bin of each holds the overflow
+//   entries : int64 per accepted entry, in increasing order
+//
+// The ROOT file checksum covers its size and its first and last MiB: ROOT
+// rewrites the file header and the keys and streamer info at the end
+// whenever a file is written, and the checksum, unlike a modification
+// time, survives copying the files to another machine. An index whose
+// file checksum, key text or own checksum does not match is rebuilt.
+
+#ifndef RAINIERIndex_h
+#define RAINIERIndex_h 1
+
+#include "globals.hh"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CascadeFilter;
+
+class RAINIERIndex
+{
+  public:
+    static const G4int kMultiplicityBins = 32;
+    static const G4int kSumBins = 200;
+    static const G4double kSumBinWidth;     // MeV
+
+    // Index of the tree treeName in the ROOT file path for filter: read from
+    // the sidecar if it is up to date, else built by reading the file and
+    // written to the sidecar. Returns nullptr (after printing the reason)
+    // if the file cannot be read.
+    static RAINIERIndex* Open(const std::string& path, const std::string& treeName,
+                              const CascadeFilter& filter);
+
+    static std::string SidecarPath(const std::string& path, const std::string& treeName,
+                                   const CascadeFilter& filter);
+
+    // Accepted entry numbers of the tree, in increasing order
+    const std::vector<G4long>& GetEntries() const { return fEntries; }
+    G4long GetTreeEntries() const { return fTreeEntries; }
+
+    // Accepted cascades per number of gammas and per summed energy bin
+    const std::vector<G4long>& GetMultiplicity() const { return fMultiplicity; }
+    const std::vector<G4long>& GetSum() const { return fSum; }
+
+    // True if the index was read from the sidecar rather than built
+    G4bool WasRead() const { return fWasRead; }
+
+  private:
+    RAINIERIndex();
+
+    // Size and checksum identifying the contents of a ROOT file
+    static G4bool FileStamp(const std::string& path, uint64_t& size, uint64_t& checksum);
+
+    G4bool Read(const std::string& sidecar, const std::string& key,
+                uint64_t fileSize, uint64_t fileChecksum);
+    G4bool Build(const std::string& path, const std::string& treeName, const CascadeFilter& filter);
+    G4bool Write(const std::string& sidecar, const std::string& key,
+                 uint64_t fileSize, uint64_t fileChecksum) const;
+
+    std::vector<G4long> fEntries;
+    std::vector<G4long> fMultiplicity;
+    std::vector<G4long> fSum;
+    G4long fTreeEntries;
+    G4bool fWasRead;
+};
+
+#endif
@@ -0,0 +1,77 @@
+// ==============================================================================
+// RAINIERSampler.hh - Per-thread random order of preloaded RAINIER cascades
+// ==============================================================================
+//
+// By default preloaded cascades are taken in file order through the shared
+// RAINIERCursor, so every pass over the library replays the same sequence.
+// With -rainier-sample each worker instead draws its own cascades without
+// replacement, in a random order that is drawn again after each pass:
+//
+//   shuffle      the cascades of the thread in a random permutation
+//   stratified   the same within each multiplicity, with the multiplicities
+//                interleaved so that every stretch of draws holds them in
+//                the proportions of the library (smooth weighted
+//                round-robin), and each pass ends with every multiplicity
+//                exhausted at the same draw
+//
+// The library is dealt out to the threads like cards (thread t of n gets
+// cascades t, t + n, ...), so no cascade is used by two threads before all
+// have been used once. Permutations are drawn lazily, one Fisher-Yates step
+// per cascade, so a pass costs nothing up front.
+//
+// Each thread's generator is seeded with SplitMix64 of the run seed and the
+// thread id: different threads get unrelated streams, and a run seed given
+// with -rainier-seed repeats the same orders.
+
+#ifndef RAINIERSampler_h
+#define RAINIERSampler_h 1
+
+#include "globals.hh"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+class RAINIERCascadeStore;
+
+class RAINIERSampler
+{
+  public:
+    enum Mode { kSequential, kShuffle, kStratified };
+
+    // Mode and run seed for all threads; set by main() before any thread
+    // exists, with the number of worker threads (1 for sequential runs)
+    static void Configure(Mode mode, uint64_t seed, G4int nThreads);
+    static Mode GetMode();
+    static uint64_t GetSeed();
+
+    // "sequential", "shuffle" or "stratified"
+    static G4bool ParseMode(const std::string& name, Mode& mode);
+    static const char* ModeName(Mode mode);
+
+    // Sampler of thread's share of store (the G4Threading thread id; -1
+    // for the master or a sequential run, which gets everything)
+    RAINIERSampler(const RAINIERCascadeStore& store, G4int thread);
+
+    // Next cascade, and its position in the endless sequence of passes
+    // (pass * number of cascades + cascade) for RAINIERCursor
+    G4long Next(G4long& position);
+
+  private:
+    // Cascades of one multiplicity, and how far their permutation got
+    struct Stratum {
+      std::vector<G4long> cascades;
+      size_t next;
+      G4long credit;
+    };
+
+    Stratum& Choose();
+
+    std::vector<Stratum> fStrata;
+    G4long fShareSize;
+    G4long fLibrarySize;
+    G4long fDraws;
+    std::mt19937_64 fEngine;
+};
+
+#endif
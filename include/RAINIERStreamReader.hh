@@ -0,0 +1,106 @@
+// ==============================================================================
+// RAINIERStreamReader.hh - RAINIER cascades streamed by a reader thread
+// ==============================================================================
+//
+// For RAINIER files too large for -rainier-preload, -rainier-stream starts
+// one reader thread that goes through the tree in order with a TTreeCache,
+// reading only the Egs branch (and Exfs for a level criterion). It applies
+// the CascadeFilter and puts each accepted cascade into a bounded lock-free ring buffer. Worker
+// threads take cascades from the ring and never call ROOT themselves, so
+// they do not wait on basket decompression unless the ring runs dry. The
+// depth of the ring and the number of times either side had to wait are
+// printed at the end of the run, to size the buffer.
+//
+// The ring is the bounded multi-producer multi-consumer queue of
+// D. Vyukov: every slot carries a sequence number telling whether it is
+// free for the next push or holds data for the next pop. The energy
+// vectors are swapped in and out of the slots, so once the vectors have
+// grown to the longest cascade no memory is allocated.
+
+#ifndef RAINIERStreamReader_h
+#define RAINIERStreamReader_h 1
+
+#include "globals.hh"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CascadeFilter;
+class TTree;
+
+class RAINIERStreamReader
+{
+  public:
+    static RAINIERStreamReader* Instance();
+
+    static const G4int kDefaultDepth = 4096;
+
+    // Chains the tree treeName of files and starts the reader thread.
+    // depth is rounded up to a power of two. With entries (global entry
+    // numbers from RAINIERIndex, which must outlive the reader) only those
+    // are read, and taken as accepted. Returns false (after printing the
+    // reason) if the chain has no entries.
+    G4bool Start(const std::vector<std::string>& files, const std::string& treeName,
+                 const CascadeFilter& filter, G4int depth = kDefaultDepth,
+                 const std::vector<G4long>* entries = nullptr);
+
+    // Stops and joins the reader thread; called once the run is over
+    void Stop();
+
+    G4bool IsActive() const { return fActive.load(std::memory_order_acquire); }
+
+    // Next cascade: its energies (MeV) are swapped into energies and its
+    // position in the endless sequence of tree entries (see RAINIERCursor)
+    // is returned in position. Waits while the ring is empty; returns
+    // false only if the reader has stopped and the ring is drained.
+    G4bool Pop(std::vector<G4double>& energies, G4long& position);
+
+    // Ring size and wait counters at the end of the run; silent if the
+    // reader was never started
+    void PrintStatistics() const;
+
+  private:
+    RAINIERStreamReader();
+    ~RAINIERStreamReader();
+    RAINIERStreamReader(const RAINIERStreamReader&);
+    RAINIERStreamReader& operator=(const RAINIERStreamReader&);
+
+    struct Slot
+    {
+      std::atomic<size_t> sequence;
+      G4long position;
+      std::vector<G4double> energies;
+    };
+
+    G4bool TryPush(G4long position, std::vector<G4double>& energies);
+    G4bool TryPop(std::vector<G4double>& energies, G4long& position);
+
+    // Body of the reader thread
+    void Read();
+
+    std::unique_ptr<Slot[]> fSlots;
+    size_t fMask;
+    alignas(64) std::atomic<size_t> fEnqueue;
+    alignas(64) std::atomic<size_t> fDequeue;
+
+    std::thread fThread;
+    TTree* fTree;                      // TChain of all RAINIER files
+    std::string fFileName;             // for messages
+    const CascadeFilter* fFilter;
+    const std::vector<G4long>* fEntries; // accepted entries, or null for all
+    std::atomic<G4bool> fActive;
+    std::atomic<G4bool> fStop;
+    std::atomic<G4bool> fFinished;     // reader thread has returned
+
+    // Counters for the end-of-run report
+    std::atomic<G4long> fPushed;
+    std::atomic<G4long> fPopped;
+    std::atomic<G4long> fDepthSum;     // ring depth seen by each pop
+    std::atomic<G4long> fStalls;       // pops that found the ring empty
+    std::atomic<G4long> fStallNs;      // time workers spent waiting
+    std::atomic<G4long> fFullWaits;    // pushes that found the ring full
+};
+
+#endif
@@ -0,0 +1,78 @@
+// ==============================================================================
+// RAINIERTextReader.hh - Streaming parser for text lists of gamma cascades
+// ==============================================================================
+//
+// Reads a .txt or .dat cascade list one line at a time through a fixed
+// read buffer, without a std::string or stream per line, so that inputs of
+// several GB are parsed at close to disk speed. Two line formats are
+// understood; lines that are blank or start with '#' are skipped:
+//
+//   E1 E2 ... En           one cascade per line, energies in MeV separated
+//                          by blanks or commas, intensity 1 (RAINIER dumps)
+//   I: E1 E2 ... En        the same with the intensity I of the cascade
+//   n level Eint Jpi E1 E2 BR
+//                          a row of gamma_pairs.txt written by
+//                          gamma_pair_enumerate: two gammas of intensity BR
+//
+// The pair-list row is recognized by its non-numeric spin-parity column.
+
+#ifndef RAINIERTextReader_h
+#define RAINIERTextReader_h 1
+
+#include "globals.hh"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class RAINIERTextReader
+{
+  public:
+    static const size_t kBufferSize = 4*1024*1024;
+
+    explicit RAINIERTextReader(const std::string& fileName);
+    ~RAINIERTextReader();
+
+    G4bool IsOpen() const { return fFile != nullptr; }
+
+    // Next cascade of the file: its energies (MeV) replace the contents of
+    // energies. Lines that cannot be parsed are counted, the first few
+    // printed, and skipped. Returns false at the end of the file.
+    G4bool Next(std::vector<G4double>& energies, G4double& intensity);
+
+    G4long GetLineNumber() const { return fLineNumber; }
+    G4long GetBadLines() const { return fBadLines; }
+    G4long GetBytesRead() const { return fBytesRead; }
+
+    // True for a .dat file, and for a .txt file whose first line that is
+    // not blank or a comment starts with a number; a .txt list of ROOT
+    // files (see RAINIERFileList) starts with a path instead
+    static G4bool IsCascadeText(const std::string& fileName);
+
+    // Parses a decimal number such as "-1.25", "9.998E-01" or ".5" that ends
+    // at a blank, a comma, a colon or end; advances p past it. Returns false,
+    // leaving p unspecified, if the text there is not such a number.
+    static G4bool ParseNumber(const char*& p, const char* end, G4double& value);
+
+  private:
+    RAINIERTextReader(const RAINIERTextReader&);
+    RAINIERTextReader& operator=(const RAINIERTextReader&);
+
+    // Next line of the file without its end-of-line; false at end of file
+    G4bool NextLine(const char*& begin, const char*& end);
+
+    // Cascade on the line [begin, end); false if the line is not a cascade
+    G4bool ParseLine(const char* begin, const char* end,
+                     std::vector<G4double>& energies, G4double& intensity);
+
+    std::string fFileName;
+    std::FILE* fFile;
+    std::vector<char> fBuffer;
+    size_t fBegin;                     // start of the unread part of fBuffer
+    size_t fEnd;                       // end of the data in fBuffer
+    G4bool fEndOfFile;
+    G4long fLineNumber;
+    G4long fBadLines;
+    G4long fBytesRead;
+};
+
+#endif
@@ -23,20 +23,25 @@ public:
 
     virtual void Merge(const G4Run*);
     
-    // Original single detector methods (maintain compatibility)
-    void AddEnergySpectrumDet1(G4double energy);
-    void AddEnergySpectrumDet2(G4double energy);
+    // Original single detector methods (maintain compatibility); weight is
+    // the statistical weight of the event (see EventAction::EventWeight)
+    void AddEnergySpectrumDet1(G4double energy, G4double weight = 1.);
+    void AddEnergySpectrumDet2(G4double energy, G4double weight = 1.);
     
     void PrintResults() const;
 
 private:
     // Original single detector data
-    std::map<G4int, G4int> fEnergyHistogramDet1;
-    std::map<G4int, G4int> fEnergyHistogramDet2;
+    std::map<G4int, G4double> fEnergyHistogramDet1;   // Summed weights per bin
+    std::map<G4int, G4double> fEnergyHistogramDet2;
     G4double fTotalEnergyDepositDet1;
     G4double fTotalEnergyDepositDet2;
     G4int fTotalEventsDet1;
     G4int fTotalEventsDet2;
+    G4double fWeightSumDet1;                          // Sum of w and of w^2
+    G4double fWeightSumDet2;
+    G4double fWeightSquaredSumDet1;
+    G4double fWeightSquaredSumDet2;
 
 
     static constexpr G4int fNbins = 10000;       // Energy bins (1 keV per bin)
@@ -45,6 +50,7 @@ private:
 
     // Helper methods
     G4int EnergyToBin(G4double energy) const;
+    void PrintWeightedEvents(G4int events, G4double sum, G4double squaredSum) const;
 };
 
 #endif
\ No newline at end of file
@@ -22,13 +22,18 @@ public:
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
 
-    void AddEnergyDepositDet1(G4double edep);
-    void AddEnergyDepositDet2(G4double edep);
+    // Energy deposit of an event with its statistical weight
+    void AddEnergyDepositDet1(G4double edep, G4double weight = 1.);
+    void AddEnergyDepositDet2(G4double edep, G4double weight = 1.);
 
 private:
     G4Accumulable<G4double> fEnergyDepositDet1;
     G4Accumulable<G4double> fEnergyDepositDet2;
-    G4Accumulable<G4int> fEventCountDet1;
+    G4Accumulable<G4int> fEventCountDet1;           // Simulated events with a deposit
     G4Accumulable<G4int> fEventCountDet2;
+    G4Accumulable<G4double> fWeightedCountDet1;     // Their summed weights
+    G4Accumulable<G4double> fWeightedCountDet2;
+    G4Accumulable<G4double> fWeightSquaredDet1;     // and summed squared weights
+    G4Accumulable<G4double> fWeightSquaredDet2;
 };
 #endif
\ No newline at end of file
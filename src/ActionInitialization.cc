@@ -18,7 +18,9 @@ ActionInitialization::ActionInitialization(const std::string& rainierFile,
                                          G4int cascadeZ,
                                          G4int cascadeA,
                                          G4double cascadeSn,
-                                         bool twoGammaOnly)
+                                         G4int cascadeBlockSize,
+                                         bool tabulatedRelaxation,
+                                         const RAINIERCascadeStore* rainierStore)
 : G4VUserActionInitialization(),
   fRAINIERFile(rainierFile),
   fGenerateCascades(generateCascades),
@@ -26,7 +28,9 @@ ActionInitialization::ActionInitialization(const std::string& rainierFile,
   fCascadeZ(cascadeZ),
   fCascadeA(cascadeA),
   fCascadeSn(cascadeSn),
-  fTwoGammaOnly(twoGammaOnly)
+  fCascadeBlockSize(cascadeBlockSize),
+  fTabulatedRelaxation(tabulatedRelaxation),
+  fRAINIERStore(rainierStore)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -48,32 +52,18 @@ void ActionInitialization::Build() const
 {
     // Primary generator
     PrimaryGeneratorAction* primaryGenerator =
-        new PrimaryGeneratorAction(fRAINIERFile, fGenerateCascades, fSourceMode);
-    primaryGenerator->SetTwoGammaOnly(fTwoGammaOnly);
+        new PrimaryGeneratorAction(fRAINIERFile, fGenerateCascades, fSourceMode, fRAINIERStore);
 
-    // Configure CASCADE isotope if in CASCADE_DIRECT mode
+    // Configure CASCADE isotope if in CASCADE_DIRECT mode. The isotope was
+    // checked against G4CASCADECatalog in main(), once for all threads.
     if (fSourceMode == CASCADE_DIRECT) {
-        // Verify CASCADE has data for requested isotope
-        G4CASCADE* tempCascade = new G4CASCADE();
-        bool hasData = tempCascade->HasData(fCascadeZ, fCascadeA);
-        delete tempCascade;
-
-        if (hasData) {
-            // Use requested isotope
-            primaryGenerator->SetIsotope(fCascadeZ, fCascadeA);
-            primaryGenerator->SetExcitationEnergy(fCascadeSn);
-            if (!g_quietMode) {
-                G4cout << "CASCADE: Using Z=" << fCascadeZ << " A=" << fCascadeA
-                       << " Sn=" << fCascadeSn << " MeV" << G4endl;
-            }
-        } else {
-            // Fall back to Cl-36 with warning
-            G4cerr << "WARNING: No CASCADE data for Z=" << fCascadeZ
-                   << " A=" << fCascadeA << G4endl;
-            G4cerr << "         Falling back to default Cl-36 (Z=17, A=36, Sn=8.579 MeV)"
-                   << G4endl;
-            primaryGenerator->SetIsotope(17, 36);
-            primaryGenerator->SetExcitationEnergy(8.579);
+        primaryGenerator->SetIsotope(fCascadeZ, fCascadeA);
+        primaryGenerator->SetExcitationEnergy(fCascadeSn);
+        primaryGenerator->SetCascadeBlockSize(fCascadeBlockSize);
+        primaryGenerator->SetTabulatedRelaxation(fTabulatedRelaxation);
+        if (!g_quietMode) {
+            G4cout << "CASCADE: Using Z=" << fCascadeZ << " A=" << fCascadeA
+                   << " Sn=" << fCascadeSn << " MeV" << G4endl;
         }
     }
 
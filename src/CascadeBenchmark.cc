@@ -0,0 +1,662 @@
+// ==============================================================================
+// CascadeBenchmark.cc - Stand-alone timing of the CASCADE generator internals
+// ==============================================================================
+
+#include "CascadeBenchmark.hh"
+#include "CascadeBlockBuffer.hh"
+#include "CascadeFilter.hh"
+#include "G4CASCADE.hh"
+#include "G4CASCADECatalog.hh"
+#include "G4CASCADEExact.hh"
+#include "G4CASCADELevelCache.hh"
+#include "G4CASCADELevelGraph.hh"
+#include "G4NucleiProperties.hh"
+#include "G4RDAtomicDeexcitation.hh"
+#include "G4RDAtomicTransitionManager.hh"
+#include "G4RDRelaxationChains.hh"
+#include "RAINIERCascadeStore.hh"
+#include "RAINIERTextReader.hh"
+#include "G4DynamicParticle.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <unistd.h>
+
+// External global variable for quiet mode
+extern bool g_quietMode;
+
+namespace {
+
+// The arguments following a stand-alone command, read from left to right
+class CommandArguments
+{
+  public:
+    CommandArguments(G4int argc, char** args) : fArgc(argc), fArgs(args), fNext(1) {}
+
+    // Reads the next argument into value if it starts with a number of
+    // that type; otherwise leaves both as they are and returns false
+    template <typename T>
+    G4bool Next(T& value)
+    {
+      if (fNext >= fArgc) return false;
+      std::istringstream ss(fArgs[fNext]);
+      T read;
+      if (!(ss >> read)) return false;
+      value = read;
+      fNext++;
+      return true;
+    }
+
+    // Reads the next argument into word unless it is an option
+    G4bool NextWord(std::string& word)
+    {
+      if (fNext >= fArgc || fArgs[fNext][0] == '-') return false;
+      word = fArgs[fNext++];
+      return true;
+    }
+
+    // Reads the isotope Z A, which must come next
+    G4bool NextIsotope(G4int& Z, G4int& A)
+    {
+      Z = A = 0;
+      if (Next(Z) && Next(A) && Z > 0 && A > 0) return true;
+      G4cout << "Error: " << fArgs[0] << " requires Z and A" << G4endl;
+      return false;
+    }
+
+  private:
+    G4int fArgc;
+    char** fArgs;
+    G4int fNext;
+};
+
+// Branch choice as GetGammas made it before the alias tables: rebuild the
+// running sum of the level's branches, then scan it linearly, redrawing when
+// the draw lands on a branch that may not be followed
+G4int SampleByScan(const G4CASCADELevelGraph& graph, G4int level, G4bool doUnplaced)
+{
+  G4int first = graph.FirstTransition(level);
+  G4int last = graph.FirstTransition(level+1);
+
+  std::vector<G4double> sumProbs;
+  G4double sum = 0.;
+  for (G4int t = first; t < last; t++) {
+    sum += graph.Probability(t);
+    sumProbs.push_back(sum);
+  }
+
+  while (true) {
+    G4double r = G4UniformRand() * sum;
+    for (G4int t = first; t < last; t++) {
+      if (r < sumProbs[t - first] && (graph.Flag(t) > 0 || doUnplaced)) {
+        return t;
+      }
+    }
+  }
+}
+
+// Walks nCascades cascades from the capture state and returns the number
+// of transitions taken; stops at continuum and dead-end levels
+template <typename Sampler>
+G4long WalkCascades(const G4CASCADELevelGraph& graph, G4long nCascades, Sampler sample)
+{
+  G4long nTransitions = 0;
+  for (G4long n = 0; n < nCascades; n++) {
+    G4int level = graph.TopLevel();
+    while (level != G4CASCADELevelGraph::kGround && !graph.IsContinuum(level)) {
+      G4int t = sample(level);
+      if (t < 0) break;
+      level = graph.Target(t);
+      nTransitions++;
+    }
+  }
+  return nTransitions;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunBranching(G4int Z, G4int A, G4long nCascades)
+{
+  const G4CASCADELevelGraph* graph = G4CASCADELevelCache::Instance()->GetLevelGraph(Z, A);
+  if (!graph) {
+    G4cerr << "ERROR: No CASCADE level data for Z=" << Z << " A=" << A << G4endl;
+    return 1;
+  }
+
+  const G4bool doUnplaced = false;
+  typedef std::chrono::steady_clock Clock;
+
+  G4cout << "CASCADE branching benchmark: Z=" << Z << " A=" << A
+         << ", " << graph->NumberOfLevels() << " levels, "
+         << graph->NumberOfTransitions() << " transitions, "
+         << nCascades << " cascades" << G4endl;
+
+  Clock::time_point start = Clock::now();
+  G4long nScan = WalkCascades(*graph, nCascades, [graph, doUnplaced](G4int level) {
+    if (graph->SampleTransition(level, doUnplaced, 0.5) < 0) return -1;
+    return SampleByScan(*graph, level, doUnplaced);
+  });
+  G4double tScan = std::chrono::duration<G4double>(Clock::now() - start).count();
+
+  start = Clock::now();
+  G4long nAlias = WalkCascades(*graph, nCascades, [graph, doUnplaced](G4int level) {
+    return graph->SampleTransition(level, doUnplaced, G4UniformRand());
+  });
+  G4double tAlias = std::chrono::duration<G4double>(Clock::now() - start).count();
+
+  G4cout << "  cumulative scan: " << nScan << " transitions in " << tScan << " s ("
+         << (tScan > 0. ? nScan / tScan : 0.) << " /s, "
+         << (G4double)nScan / nCascades << " per cascade)" << G4endl;
+  G4cout << "  alias table:     " << nAlias << " transitions in " << tAlias << " s ("
+         << (tAlias > 0. ? nAlias / tAlias : 0.) << " /s, "
+         << (G4double)nAlias / nCascades << " per cascade)" << G4endl;
+  if (tAlias > 0. && nScan > 0) {
+    G4cout << "  speed-up: " << (nAlias / tAlias) / (nScan / tScan) << "x" << G4endl;
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunAtomicStartup(G4int Z)
+{
+  if (Z < 1 || Z > 100) {
+    G4cerr << "ERROR: No atomic relaxation data for Z=" << Z << G4endl;
+    return 1;
+  }
+
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  G4long rss = ResidentSetSize();
+
+  G4cout << "Atomic relaxation start-up: Z=" << Z << G4endl;
+  G4cout << "  step                          time (ms)   RSS (MB)" << G4endl;
+  auto report = [&start, &rss](const char* step) {
+    G4double ms = std::chrono::duration<G4double, std::milli>(Clock::now() - start).count();
+    G4long now = ResidentSetSize();
+    G4cout << "  " << std::left << std::setw(30) << step << std::right << std::fixed
+           << std::setprecision(2) << std::setw(9) << ms << std::setw(11)
+           << now / 1048576. << " (+" << (now - rss) / 1024 << " kB)" << G4endl;
+    start = Clock::now();
+    rss = now;
+  };
+
+  G4RDAtomicTransitionManager* manager = G4RDAtomicTransitionManager::Instance();
+  report("Instance()");
+
+  G4int nShells = manager->NumberOfShells(Z);
+  G4int nReachable = (Z >= 6) ? manager->NumberOfReachableShells(Z) : 0;
+  for (G4int i = 0; i < nReachable; i++) manager->ReachableShell(Z, i);
+  report("first use of Z");
+
+  // What the constructor did before the tables were loaded on demand
+  for (G4int z = 1; z <= 100; z++) {
+    manager->NumberOfShells(z);
+    if (z >= 6) manager->NumberOfReachableShells(z);
+  }
+  report("all elements (eager)");
+
+  G4cout << std::defaultfloat << std::setprecision(6);
+  G4cout << "  Z=" << Z << ": " << nShells << " shells, " << nReachable
+         << " with radiative transitions" << G4endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunRelaxation(G4int Z, G4long nDraws)
+{
+  const G4RDRelaxationTable* table = (Z >= 6 && Z <= 100)
+    ? G4RDAtomicTransitionManager::Instance()->RelaxationTable(Z) : 0;
+  if (!table) {
+    G4cerr << "ERROR: No atomic relaxation data for Z=" << Z << G4endl;
+    return 1;
+  }
+  if (nDraws < 1) nDraws = 1;
+
+  typedef std::chrono::steady_clock Clock;
+  typedef std::vector<G4double> Outcome;   // photon energies in emission order
+
+  G4cout << "Whole-chain relaxation tables against the stepwise sampler: Z=" << Z
+         << ", " << nDraws << " relaxations per vacancy" << G4endl;
+  G4cout << "  shell  outcomes   stepwise (ns)  tabulated (ns)   chi2/ndf        p" << G4endl;
+
+  G4int failures = 0;
+  const G4RDAtomicDeexcitation deexcitation(false);
+  std::vector<G4DynamicParticle*> products;
+  const G4int shellIds[3] = { 1, 3, 8 };
+
+  for (G4int shellId : shellIds) {
+    if (table->Vacancy(shellId) < 0) continue;
+    Clock::time_point start = Clock::now();
+    const G4RDRelaxationChains* chains = G4RDRelaxationChains::Get(Z, shellId);
+    G4double buildMs = std::chrono::duration<G4double, std::milli>(Clock::now() - start).count();
+    if (!chains || !chains->IsComplete()) {
+      G4cout << "  " << std::setw(5) << shellId << "  too many chains to list" << G4endl;
+      continue;
+    }
+
+    // Stepwise: counts per photon-energy sequence
+    std::map<Outcome, std::array<G4long, 2>> counts;
+    Outcome outcome;
+    start = Clock::now();
+    for (G4long i = 0; i < nDraws; i++) {
+      products.clear();
+      deexcitation.GenerateParticles(*table, shellId, products);
+      outcome.clear();
+      for (size_t k = 0; k < products.size(); k++) {
+        outcome.push_back(products[k]->GetKineticEnergy());
+        delete products[k];
+      }
+      counts[outcome][0]++;
+    }
+    G4double stepNs = std::chrono::duration<G4double, std::nano>(Clock::now() - start).count() / nDraws;
+
+    // Tabulated: one draw per relaxation, plus the two deviates of each
+    // photon direction that the stepwise sampler also spends
+    std::vector<G4long> tabulated(chains->NumberOfOutcomes(), 0);
+    start = Clock::now();
+    for (G4long i = 0; i < nDraws; i++) {
+      G4int o = chains->Sample(G4UniformRand());
+      for (G4int k = 0; k < chains->NumberOfPhotons(o); k++) {
+        G4UniformRand();
+        G4UniformRand();
+      }
+      tabulated[o]++;
+    }
+    G4double tabNs = std::chrono::duration<G4double, std::nano>(Clock::now() - start).count() / nDraws;
+
+    for (G4int o = 0; o < chains->NumberOfOutcomes(); o++) {
+      outcome.clear();
+      for (G4int k = 0; k < chains->NumberOfPhotons(o); k++) outcome.push_back(chains->PhotonEnergy(o, k));
+      counts[outcome][1] += tabulated[o];
+    }
+
+    // Two-sample chi-square with equal sample sizes; sequences seen fewer
+    // than 10 times in total are pooled into one bin
+    G4double chi2 = 0.;
+    G4int nBins = 0;
+    G4long pooled[2] = { 0, 0 };
+    for (auto& entry : counts) {
+      G4long a = entry.second[0], b = entry.second[1];
+      if (a + b < 10) {
+        pooled[0] += a;
+        pooled[1] += b;
+        continue;
+      }
+      chi2 += G4double(a - b) * (a - b) / (a + b);
+      nBins++;
+    }
+    if (pooled[0] + pooled[1] > 0) {
+      chi2 += G4double(pooled[0] - pooled[1]) * (pooled[0] - pooled[1]) / (pooled[0] + pooled[1]);
+      nBins++;
+    }
+    G4int ndf = std::max(nBins - 1, 1);
+
+    // Upper tail of chi2 through the Wilson-Hilferty normal approximation
+    G4double v = 2. / (9. * ndf);
+    G4double z = (std::cbrt(chi2 / ndf) - (1. - v)) / std::sqrt(v);
+    G4double p = 0.5 * std::erfc(z / std::sqrt(2.));
+    if (p < 1.e-3) failures++;
+
+    G4cout << "  " << std::setw(5) << shellId << std::setw(10) << chains->NumberOfOutcomes()
+           << std::fixed << std::setprecision(1) << std::setw(16) << stepNs
+           << std::setw(16) << tabNs << std::setprecision(3) << std::setw(11) << chi2 / ndf
+           << std::setw(9) << p << "   (table built in " << std::setprecision(2)
+           << buildMs << " ms)" << G4endl;
+    G4cout << std::defaultfloat << std::setprecision(6);
+  }
+
+  if (failures) {
+    G4cerr << "ERROR: " << failures << " vacancies differ between the two samplers" << G4endl;
+  }
+  return failures ? 1 : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long CascadeBenchmark::ResidentSetSize()
+{
+  // Second field of /proc/self/statm: resident pages
+  std::ifstream statm("/proc/self/statm");
+  G4long totalPages = 0, residentPages = 0;
+  if (!(statm >> totalPages >> residentPages)) return 0;
+  return residentPages * sysconf(_SC_PAGESIZE);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunMemory(G4int Z, G4int A, G4long nEvents)
+{
+  G4CASCADECatalog* catalog = G4CASCADECatalog::Instance();
+  if (!catalog->HasIsotope(Z, A)) {
+    G4cerr << "ERROR: No CASCADE level data for Z=" << Z << " A=" << A << G4endl;
+    return 1;
+  }
+  if (nEvents < 10) nEvents = 10;
+
+  // Compound nucleus at rest in the capture state
+  G4double Sn = catalog->GetTopLevelEnergy(Z, A);
+  G4double mass = G4NucleiProperties::GetNuclearMass(A, Z) + Sn;
+  G4Fragment nucleus(A, Z, G4LorentzVector(0., 0., 0., mass));
+
+  G4CASCADE cascade;
+  const G4int nCheckpoints = 10;
+  std::vector<G4long> rss;
+  G4long nProducts = 0;
+
+  G4cout << "CASCADE memory check: Z=" << Z << " A=" << A << ", "
+         << nEvents << " events" << G4endl;
+  G4cout << "      events     RSS (MB)" << G4endl;
+
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  for (G4long n = 1; n <= nEvents; n++) {
+    G4ReactionProductVector* products = cascade.GetGammas(nucleus, false, false);
+    nProducts += products->size();
+    for (size_t i = 0; i < products->size(); i++) delete (*products)[i];
+    delete products;
+
+    if (n % (nEvents / nCheckpoints) == 0 || n == nEvents) {
+      rss.push_back(ResidentSetSize());
+      G4cout << std::setw(12) << n << std::setw(13) << std::fixed << std::setprecision(2)
+             << rss.back() / 1048576. << G4endl;
+    }
+  }
+  G4double seconds = std::chrono::duration<G4double>(Clock::now() - start).count();
+  G4cout << std::defaultfloat << std::setprecision(6);
+
+  // Growth after the first checkpoint, which covers the lazy loading of the
+  // level graph, the photon evaporation and the atomic data
+  G4long growth = rss.back() - rss.front();
+  const G4long tolerance = 2 * 1048576;
+  G4cout << "  " << (G4double)nProducts / nEvents << " products per event, "
+         << nEvents / seconds << " events/s" << G4endl;
+  G4cout << "  RSS growth after warm-up: " << growth / 1024 << " kB (tolerance "
+         << tolerance / 1024 << " kB): " << (growth <= tolerance ? "PASS" : "FAIL") << G4endl;
+  return (growth <= tolerance) ? 0 : 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunBlockSizes(G4int Z, G4int A, G4long nEvents)
+{
+  G4CASCADECatalog* catalog = G4CASCADECatalog::Instance();
+  if (!catalog->HasIsotope(Z, A)) {
+    G4cerr << "ERROR: No CASCADE level data for Z=" << Z << " A=" << A << G4endl;
+    return 1;
+  }
+
+  G4double Sn = catalog->GetTopLevelEnergy(Z, A);
+  G4double mass = G4NucleiProperties::GetNuclearMass(A, Z) + Sn;
+  G4Fragment nucleus(A, Z, G4LorentzVector(0., 0., 0., mass));
+  G4CASCADE cascade;
+
+  // Stand-in for the tracking between two events: walk 4 MB, one cache line
+  // at a time
+  std::vector<char> trackingWorkingSet(4 * 1048576, 1);
+  G4long sink = 0;
+
+  G4cout << "CASCADE block size benchmark: Z=" << Z << " A=" << A << ", "
+         << nEvents << " events per block size" << G4endl;
+  G4cout << "  block size   ns/event   gammas/event" << G4endl;
+
+  typedef std::chrono::steady_clock Clock;
+  for (G4int blockSize = 1; blockSize <= 65536; blockSize *= 4) {
+    CascadeBlockBuffer block(blockSize);
+    block.Refill(cascade, nucleus);   // warm-up: sizes the arrays once
+    block.Invalidate();
+
+    Clock::duration generatorTime = Clock::duration::zero();
+    G4long nGammas = 0;
+    for (G4long n = 0; n < nEvents; n++) {
+      Clock::time_point start = Clock::now();
+      G4int c = block.NextCascade(cascade, nucleus);
+      G4double sum = 0.;
+      for (G4int i = block.Offset(c); i < block.Offset(c) + block.Multiplicity(c); i++) {
+        sum += block.Energy(i) * block.Direction(i).z();
+      }
+      nGammas += block.Multiplicity(c);
+      generatorTime += Clock::now() - start;
+
+      sink += (G4long)sum;
+      for (size_t b = 0; b < trackingWorkingSet.size(); b += 64) {
+        sink += trackingWorkingSet[b]++;
+      }
+    }
+
+    G4double ns = std::chrono::duration<G4double, std::nano>(generatorTime).count();
+    G4cout << std::setw(12) << blockSize << std::setw(11) << std::fixed << std::setprecision(1)
+           << ns / nEvents << std::setw(15) << std::setprecision(3)
+           << (G4double)nGammas / nEvents << G4endl;
+  }
+  G4cout << std::defaultfloat << std::setprecision(6);
+  return (sink == -1) ? 1 : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunTextParse(const std::string& fileName, G4long megabytes)
+{
+  typedef std::chrono::steady_clock Clock;
+  std::string path = fileName;
+  if (path.empty()) {
+    // Cascades of 1 to 8 gammas summing to at most 9 MeV, every tenth line
+    // with an intensity, as a RAINIER dump with a few weighted entries
+    path = "hpgedual_bench_cascades.dat";
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+      G4cerr << "ERROR: Cannot write " << path << G4endl;
+      return 1;
+    }
+    G4long bytes = 0;
+    for (G4long line = 0; bytes < megabytes * 1048576; line++) {
+      if (line % 10 == 0) bytes += std::fprintf(out, "%.4f: ", 0.5 + G4UniformRand());
+      G4int n = 1 + (G4int)(8 * G4UniformRand());
+      G4double left = 9.;
+      for (G4int i = 0; i < n; i++) {
+        G4double energy = left * G4UniformRand();
+        left -= energy;
+        bytes += std::fprintf(out, i + 1 < n ? "%.6f " : "%.6f\n", energy);
+      }
+    }
+    std::fclose(out);
+    G4cout << "Wrote " << megabytes << " MB of synthetic cascades to " << path << G4endl;
+  }
+
+  G4cout << "Text cascade list parsing: " << path << G4endl;
+  G4cout << "                        MB/s   lines/s (M)" << G4endl;
+
+  // Streaming parser
+  Clock::time_point start = Clock::now();
+  RAINIERTextReader reader(path);
+  if (!reader.IsOpen()) {
+    G4cerr << "ERROR: Cannot open " << path << G4endl;
+    return 1;
+  }
+  std::vector<G4double> energies;
+  G4double intensity, sink = 0.;
+  G4long nCascades = 0;
+  while (reader.Next(energies, intensity)) {
+    sink += energies[0] * intensity;
+    nCascades++;
+  }
+  G4double seconds = std::chrono::duration<G4double>(Clock::now() - start).count();
+  G4double megabytesRead = reader.GetBytesRead() / 1048576.;
+  G4cout << "  RAINIERTextReader " << std::setw(9) << std::fixed << std::setprecision(1)
+         << megabytesRead / seconds << std::setw(10) << std::setprecision(2)
+         << reader.GetLineNumber() / seconds / 1e6 << G4endl;
+
+  // The line-by-line stream parsing a naive reader would do
+  start = Clock::now();
+  std::ifstream in(path);
+  std::string line;
+  G4long nLines = 0;
+  while (std::getline(in, line)) {
+    nLines++;
+    if (line.empty() || line[0] == '#') continue;
+    size_t colon = line.find(':');
+    if (colon != std::string::npos) line[colon] = ' ';
+    std::istringstream fields(line);
+    G4double value;
+    while (fields >> value) sink += value;
+  }
+  seconds = std::chrono::duration<G4double>(Clock::now() - start).count();
+  G4cout << "  getline/istream   " << std::setw(9) << std::setprecision(1)
+         << megabytesRead / seconds << std::setw(10) << std::setprecision(2)
+         << nLines / seconds / 1e6 << G4endl;
+
+  // Loading into the store (parse, select, alias table) and drawing
+  start = Clock::now();
+  RAINIERCascadeStore* store = RAINIERCascadeStore::LoadText(path, *CascadeFilter::Instance());
+  seconds = std::chrono::duration<G4double>(Clock::now() - start).count();
+  if (!store) return 1;
+  G4cout << "  load into store: " << std::setprecision(2) << seconds << " s for "
+         << store->GetNumberOfCascades() << " cascades, "
+         << std::setprecision(1) << store->MemoryUsage() / 1048576. << " MB" << G4endl;
+
+  const G4long nDraws = 10000000;
+  start = Clock::now();
+  for (G4long n = 0; n < nDraws; n++) {
+    G4long c = store->IsWeighted() ? store->Sample(G4UniformRand())
+                                   : (G4long)(G4UniformRand() * store->GetNumberOfCascades());
+    sink += store->Energies(c)[0];
+  }
+  G4double ns = std::chrono::duration<G4double, std::nano>(Clock::now() - start).count() / nDraws;
+  G4cout << "  draw a cascade" << (store->IsWeighted() ? " by intensity: " : ": ")
+         << std::setprecision(1) << ns << " ns" << G4endl;
+  G4cout << std::defaultfloat << std::setprecision(6);
+  delete store;
+
+  if (fileName.empty()) std::remove(path.c_str());
+  return (nCascades == 0 || sink == -1.) ? 1 : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunExact(G4int Z, G4int A, const std::string& fileName)
+{
+  const G4CASCADELevelGraph* graph = G4CASCADELevelCache::Instance()->GetLevelGraph(Z, A);
+  if (!graph) {
+    G4cerr << "ERROR: No CASCADE level data for Z=" << Z << " A=" << A
+           << " (see -list-isotopes)" << G4endl;
+    return 1;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  G4CASCADEExact exact(*graph);
+  std::ostringstream table;
+  exact.WriteTable(table, 1.e-5);
+  G4double elapsed = std::chrono::duration<G4double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+
+  if (fileName.empty()) {
+    G4cout << table.str() << "# Computed in " << elapsed << " ms" << G4endl;
+    return 0;
+  }
+  std::ofstream out(fileName);
+  if (!out) {
+    G4cerr << "ERROR: Cannot write " << fileName << G4endl;
+    return 1;
+  }
+  out << table.str();
+  G4cout << "Exact CASCADE table for Z=" << Z << " A=" << A
+         << " written to " << fileName << " (" << elapsed << " ms)" << G4endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CascadeBenchmark::IsCommand(const std::string& arg)
+{
+  return arg == "-exact" || arg == "-bench-branching" || arg == "-bench-memory"
+      || arg == "-bench-block" || arg == "-bench-atomic" || arg == "-bench-relaxation"
+      || arg == "-bench-text";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CascadeBenchmark::RunCommand(G4int argc, char** args)
+{
+  CommandArguments arguments(argc, args);
+  std::string command = args[0];
+  G4int Z = 0, A = 0;
+
+  if (command == "-bench-branching") {
+    // -bench-branching Z A [N]
+    G4long n = 1000000;
+    if (!arguments.NextIsotope(Z, A)) return 1;
+    arguments.Next(n);
+    return RunBranching(Z, A, n);
+  }
+
+  if (command == "-bench-memory") {
+    // -bench-memory Z A [N]
+    G4long n = 10000000;
+    if (!arguments.NextIsotope(Z, A)) return 1;
+    arguments.Next(n);
+    g_quietMode = true;
+    return RunMemory(Z, A, n);
+  }
+
+  if (command == "-bench-block") {
+    // -bench-block Z A [N]
+    G4long n = 200000;
+    if (!arguments.NextIsotope(Z, A)) return 1;
+    arguments.Next(n);
+    g_quietMode = true;
+    return RunBlockSizes(Z, A, n);
+  }
+
+  if (command == "-exact") {
+    // -exact Z A [file]
+    std::string fileName;
+    if (!arguments.NextIsotope(Z, A)) return 1;
+    arguments.NextWord(fileName);
+    g_quietMode = true;
+    return RunExact(Z, A, fileName);
+  }
+
+  if (command == "-bench-atomic") {
+    // -bench-atomic [Z]
+    Z = 17;
+    arguments.Next(Z);
+    g_quietMode = true;
+    return RunAtomicStartup(Z);
+  }
+
+  if (command == "-bench-relaxation") {
+    // -bench-relaxation [Z] [N]
+    G4long n = 1000000;
+    Z = 17;
+    if (arguments.Next(Z)) arguments.Next(n);
+    g_quietMode = true;
+    return RunRelaxation(Z, n);
+  }
+
+  if (command == "-bench-text") {
+    // -bench-text [file|MB]: a file name unless the whole argument is a number
+    std::string fileName;
+    G4long megabytes = 1024;
+    if (arguments.NextWord(fileName)) {
+      std::istringstream ss(fileName);
+      if (ss >> megabytes && ss.eof()) fileName.clear();
+      else megabytes = 0;
+    }
+    g_quietMode = true;
+    return RunTextParse(fileName, megabytes);
+  }
+
+  G4cerr << "ERROR: Unknown option " << command << " (see -h)" << G4endl;
+  return 1;
+}
@@ -0,0 +1,58 @@
+// ==============================================================================
+// CascadeBlockBuffer.cc - Block of pre-generated CASCADE gamma cascades
+// ==============================================================================
+
+#include "CascadeBlockBuffer.hh"
+#include "G4CASCADE.hh"
+#include "G4Gamma.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CascadeBlockBuffer::CascadeBlockBuffer(G4int blockSize)
+: fBlockSize(1),
+  fNext(0)
+{
+    SetBlockSize(blockSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CascadeBlockBuffer::SetBlockSize(G4int blockSize)
+{
+    fBlockSize = (blockSize < 1) ? 1 : blockSize;
+    fOffset.reserve(fBlockSize);
+    fMultiplicity.reserve(fBlockSize);
+    Invalidate();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CascadeBlockBuffer::Refill(G4CASCADE& generator, const G4Fragment& nucleus)
+{
+    // The arrays keep their capacity, so after the first blocks a refill
+    // does not allocate
+    fOffset.clear();
+    fMultiplicity.clear();
+    fEnergy.clear();
+    fDirX.clear();
+    fDirY.clear();
+    fDirZ.clear();
+
+    const G4ParticleDefinition* gamma = G4Gamma::Gamma();
+    for (G4int n = 0; n < fBlockSize; n++) {
+        generator.GenerateCascade(nucleus, false, false, fScratch);
+
+        G4int first = (G4int)fEnergy.size();
+        for (size_t i = 0; i < fScratch.Size(); i++) {
+            const G4CASCADEParticle& particle = fScratch[i];
+            if (particle.definition != gamma) continue;
+            fEnergy.push_back(particle.energy);
+            fDirX.push_back(particle.direction.x());
+            fDirY.push_back(particle.direction.y());
+            fDirZ.push_back(particle.direction.z());
+        }
+        fOffset.push_back(first);
+        fMultiplicity.push_back((G4int)fEnergy.size() - first);
+    }
+    fNext = 0;
+}
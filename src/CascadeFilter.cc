@@ -0,0 +1,306 @@
+// ==============================================================================
+// CascadeFilter.cc - Selection of gamma cascades before tracking
+// ==============================================================================
+
+#include "CascadeFilter.hh"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+const char* const CascadeFilter::kTwoGammaOnly = "mult=2,esum=5.4-";
+const G4double CascadeFilter::kDefaultTolerance = 0.002;
+
+namespace {
+
+const G4double kInfinity = std::numeric_limits<G4double>::infinity();
+
+G4bool ParseDouble(const std::string& text, G4double& value)
+{
+  if (text.empty()) return false;
+  char* end;
+  value = std::strtod(text.c_str(), &end);
+  return *end == '\0';
+}
+
+G4bool ParseInt(const std::string& text, G4int& value)
+{
+  if (text.empty()) return false;
+  char* end;
+  long v = std::strtol(text.c_str(), &end, 10);
+  value = (G4int)v;
+  return *end == '\0' && v >= 0 && v < INT_MAX;
+}
+
+// "A-B" or "A-" (upper empty); the '-' is searched after the first
+// character so that A may be negative
+G4bool SplitRange(const std::string& text, std::string& lower, std::string& upper)
+{
+  size_t dash = text.find('-', 1);
+  if (dash == std::string::npos) return false;
+  lower = text.substr(0, dash);
+  upper = text.substr(dash + 1);
+  return true;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CascadeFilter* CascadeFilter::Instance()
+{
+  static CascadeFilter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CascadeFilter::CascadeFilter()
+: fActive(false),
+  fMinMultiplicity(0),
+  fMaxMultiplicity(-1),
+  fMinSum(-kInfinity),
+  fMaxSum(kInfinity),
+  fEvaluated(0),
+  fConditional(0),
+  fRetries(0),
+  fReachable(1.)
+{
+  for (G4int i = 0; i < kNCriteria; i++) fRejected[i].store(0, std::memory_order_relaxed);
+}
+
+CascadeFilter::~CascadeFilter()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CascadeFilter::Parse(const std::string& spec)
+{
+  std::stringstream criteria(spec);
+  std::string criterion;
+  while (std::getline(criteria, criterion, ',')) {
+    if (criterion.empty()) continue;
+    size_t equals = criterion.find('=');
+    std::string key = criterion.substr(0, equals);
+    std::string value = equals == std::string::npos ? "" : criterion.substr(equals + 1);
+    G4bool ok = false;
+
+    if (key == "mult") {
+      // Several mult criteria give the intersection of their ranges
+      std::string lower, upper;
+      G4int min, max = -1;
+      if (SplitRange(value, lower, upper)) {
+        ok = ParseInt(lower, min) && (upper.empty() || (ParseInt(upper, max) && max >= min));
+      } else {
+        ok = ParseInt(value, min);
+        max = min;
+      }
+      if (ok) {
+        fMinMultiplicity = std::max(fMinMultiplicity, min);
+        if (max >= 0) fMaxMultiplicity = fMaxMultiplicity < 0 ? max : std::min(fMaxMultiplicity, max);
+      }
+    } else if (key == "esum") {
+      std::string lower, upper;
+      G4double min, max = kInfinity;
+      ok = SplitRange(value, lower, upper) && ParseDouble(lower, min) &&
+           (upper.empty() || (ParseDouble(upper, max) && max > min));
+      if (ok) {
+        fMinSum = std::max(fMinSum, min);
+        fMaxSum = std::min(fMaxSum, max);
+      }
+    } else if (key == "line" || key == "level") {
+      size_t slash = value.find('/');
+      Window window = { 0., kDefaultTolerance };
+      ok = ParseDouble(value.substr(0, slash), window.energy) &&
+           (slash == std::string::npos ||
+            (ParseDouble(value.substr(slash + 1), window.tolerance) && window.tolerance >= 0.));
+      if (ok) (key == "line" ? fLines : fLevels).push_back(window);
+    }
+
+    if (!ok) {
+      G4cerr << "ERROR: Bad cascade filter criterion '" << criterion << "'"
+             << " (expected mult=N[-M], esum=A-[B], line=E[/tol] or level=E[/tol])" << G4endl;
+      return false;
+    }
+    fActive = true;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string CascadeFilter::GetDescription() const
+{
+  std::ostringstream text;
+  const char* separator = "";
+  if (fMinMultiplicity > 0 || fMaxMultiplicity >= 0) {
+    text << "mult=" << fMinMultiplicity;
+    if (fMaxMultiplicity != fMinMultiplicity) {
+      text << "-";
+      if (fMaxMultiplicity >= 0) text << fMaxMultiplicity;
+    }
+    separator = ",";
+  }
+  if (fMinSum > -kInfinity || fMaxSum < kInfinity) {
+    text << separator << "esum=" << (fMinSum > -kInfinity ? fMinSum : 0.) << "-";
+    if (fMaxSum < kInfinity) text << fMaxSum;
+    separator = ",";
+  }
+  for (const Window& line : fLines) {
+    text << separator << "line=" << line.energy << "/" << line.tolerance;
+    separator = ",";
+  }
+  for (const Window& level : fLevels) {
+    text << separator << "level=" << level.energy << "/" << level.tolerance;
+    separator = ",";
+  }
+  return text.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CascadeFilter::Criterion CascadeFilter::FirstFailure(const G4double* energies, size_t n,
+                                                     const G4double* levels, size_t nLevels) const
+{
+  if (n == 0) return kEmpty;
+  if ((G4int)n < fMinMultiplicity || (fMaxMultiplicity >= 0 && (G4int)n > fMaxMultiplicity)) {
+    return kMultiplicity;
+  }
+  G4double sum = 0.;
+  for (size_t i = 0; i < n; i++) sum += energies[i];
+  if (!(sum > fMinSum && sum <= fMaxSum)) return kSum;
+
+  for (const Window& line : fLines) {
+    if (std::none_of(energies, energies + n, [&line](G4double e) { return line.Contains(e); })) {
+      return kLine;
+    }
+  }
+  for (const Window& level : fLevels) {
+    if (!levels || std::none_of(levels, levels + nLevels,
+                                [&level](G4double e) { return level.Contains(e); })) {
+      return kLevel;
+    }
+  }
+  return kNCriteria;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CascadeFilter::Accept(const G4double* energies, size_t n,
+                             const G4double* levels, size_t nLevels) const
+{
+  Criterion failure = FirstFailure(energies, n, levels, nLevels);
+  fEvaluated.fetch_add(1, std::memory_order_relaxed);
+  if (failure == kNCriteria) return true;
+  fRejected[failure].fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long CascadeFilter::Evaluate(const G4double* energies, const G4long* offsets,
+                               const G4double* levels, const G4long* levelOffsets,
+                               G4long nCascades, std::vector<char>& pass) const
+{
+  // One criterion at a time over the whole batch, each a short loop
+  // without calls that the compiler can unroll and vectorize; later
+  // criteria only look at cascades that are still in
+  pass.resize(nCascades);
+  G4long rejected[kNCriteria] = { 0 };
+
+  G4long minMultiplicity = fMinMultiplicity;
+  G4long maxMultiplicity = fMaxMultiplicity >= 0 ? fMaxMultiplicity : LONG_MAX;
+  for (G4long c = 0; c < nCascades; c++) {
+    G4long n = offsets[c+1] - offsets[c];
+    char empty = (n == 0);
+    char inRange = (n >= minMultiplicity) & (n <= maxMultiplicity);
+    rejected[kEmpty] += empty;
+    rejected[kMultiplicity] += (!empty) & (!inRange);
+    pass[c] = (!empty) & inRange;
+  }
+
+  if (fMinSum > -kInfinity || fMaxSum < kInfinity) {
+    for (G4long c = 0; c < nCascades; c++) {
+      G4double sum = 0.;
+      for (G4long i = offsets[c]; i < offsets[c+1]; i++) sum += energies[i];
+      char inWindow = (sum > fMinSum) & (sum <= fMaxSum);
+      rejected[kSum] += pass[c] & (!inWindow);
+      pass[c] &= inWindow;
+    }
+  }
+
+  for (const Window& line : fLines) {
+    for (G4long c = 0; c < nCascades; c++) {
+      if (!pass[c]) continue;
+      char found = 0;
+      for (G4long i = offsets[c]; i < offsets[c+1]; i++) found |= line.Contains(energies[i]);
+      rejected[kLine] += !found;
+      pass[c] = found;
+    }
+  }
+
+  for (const Window& level : fLevels) {
+    for (G4long c = 0; c < nCascades; c++) {
+      if (!pass[c]) continue;
+      char found = 0;
+      if (levels) {
+        for (G4long i = levelOffsets[c]; i < levelOffsets[c+1]; i++) found |= level.Contains(levels[i]);
+      }
+      rejected[kLevel] += !found;
+      pass[c] = found;
+    }
+  }
+
+  G4long nRejected = 0;
+  for (G4int i = 0; i < kNCriteria; i++) {
+    fRejected[i].fetch_add(rejected[i], std::memory_order_relaxed);
+    nRejected += rejected[i];
+  }
+  fEvaluated.fetch_add(nCascades, std::memory_order_relaxed);
+  return nCascades - nRejected;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CascadeFilter::RecordConditional(G4double reachable, G4long retries) const
+{
+  fConditional.fetch_add(1, std::memory_order_relaxed);
+  fRetries.fetch_add(retries, std::memory_order_relaxed);
+  fReachable.store(reachable, std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CascadeFilter::PrintStatistics() const
+{
+  if (!fActive) return;
+
+  G4long evaluated = fEvaluated.load(std::memory_order_relaxed);
+  G4long conditional = fConditional.load(std::memory_order_relaxed);
+  if (evaluated == 0 && conditional == 0) return;
+
+  G4cout << "Cascade filter " << GetDescription() << ":" << G4endl;
+  if (evaluated > 0) {
+    static const char* const names[kNCriteria] = { "empty", "multiplicity", "sum", "line", "level" };
+    G4long rejected = 0;
+    for (G4int i = 0; i < kNCriteria; i++) rejected += fRejected[i].load(std::memory_order_relaxed);
+    G4cout << "  RAINIER: " << evaluated - rejected << " of " << evaluated << " cascades accepted ("
+           << std::fixed << std::setprecision(2) << 100. * (evaluated - rejected) / evaluated
+           << "%); rejected by";
+    for (G4int i = 0; i < kNCriteria; i++) {
+      G4cout << (i == 0 ? " " : ", ") << names[i] << " " << fRejected[i].load(std::memory_order_relaxed);
+    }
+    G4cout << G4endl;
+  }
+  if (conditional > 0) {
+    G4double reachable = fReachable.load(std::memory_order_relaxed);
+    G4cout << "  CASCADE: " << conditional << " cascades drawn conditionally, "
+           << fRetries.load(std::memory_order_relaxed) << " redrawn for criteria the level scheme"
+           << " does not decide; an unconditioned cascade passes with probability "
+           << std::scientific << std::setprecision(3) << reachable << G4endl;
+  }
+  G4cout << std::defaultfloat << std::setprecision(6);
+}
@@ -0,0 +1,41 @@
+// ==============================================================================
+// CascadeMessenger.cc - /cascade/ UI commands
+// ==============================================================================
+
+#include "CascadeMessenger.hh"
+#include "G4CASCADECatalog.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CascadeMessenger::CascadeMessenger()
+: G4UImessenger()
+{
+    fCascadeDir = new G4UIdirectory("/cascade/");
+    fCascadeDir->SetGuidance("CASCADE neutron capture gamma generator");
+
+    fListIsotopesCmd = new G4UIcmdWithoutParameter("/cascade/listIsotopes", this);
+    fListIsotopesCmd->SetGuidance("List the isotopes with CapGam level data and their");
+    fListIsotopesCmd->SetGuidance("capture state energies (the Sn to use with -cascade).");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CascadeMessenger::~CascadeMessenger()
+{
+    delete fListIsotopesCmd;
+    delete fCascadeDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CascadeMessenger::SetNewValue(G4UIcommand* command, G4String)
+{
+    if (command == fListIsotopesCmd) {
+        G4CASCADECatalog::Instance()->ListIsotopes();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
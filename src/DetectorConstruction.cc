@@ -27,6 +27,8 @@
 // Static member definitions
 const G4double DetectorConstruction::fWorldSize = 100.0*cm;  // Increased for dual setup
 const G4double DetectorConstruction::fSourceDetectorDistance = 5.0*cm;  // Distance from detector surface to source aka origin
+const G4double DetectorConstruction::fShieldStartDistance = 25.0*mm;   // Front face of the lead shields
+const G4double DetectorConstruction::fTargetOpeningRadius = 10.0*mm;   // Collimator opening at the front face
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -302,9 +304,9 @@ void DetectorConstruction::ConstructLeadShield(G4LogicalVolume* motherVolume,
     G4double housingLength = 76.0*mm;
 
     // Shield specifications
-    G4double targetOpeningRadius = 10.0*mm;      // 2cm diameter opening at target
+    G4double targetOpeningRadius = fTargetOpeningRadius;  // 2cm diameter opening at target
     G4double collimatorRadius = 38.5*mm;         // 77mm diameter (housing + 1cm)
-    G4double shieldStartDist = 25.0*mm;          // 2.5cm from origin (5cm gap between shields)
+    G4double shieldStartDist = fShieldStartDistance;      // 2.5cm from origin (5cm gap between shields)
     G4double leadThickness = 50.0*mm;            // 5cm lead thickness
 
     // Absolute positions along Z axis
@@ -370,6 +372,27 @@ void DetectorConstruction::ConstructLeadShield(G4LogicalVolume* motherVolume,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4ThreeVector DetectorConstruction::GetDetectorAxis(G4int detectorID) const
+{
+    // Same placement as in DefineVolumes()
+    if (detectorID == 2) {
+        G4double angleRad = fDetector2Angle * deg;
+        return G4ThreeVector(sin(angleRad), 0, cos(angleRad));
+    }
+    return G4ThreeVector(0, 0, 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double DetectorConstruction::GetCollimatorHalfAngle() const
+{
+    // The collimator widens from the opening towards the detector, so from
+    // the source the opening at the front face of the shield is the limit
+    return std::atan(fTargetOpeningRadius / fShieldStartDistance);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 G4double DetectorConstruction::CalculateDetectionEfficiency(G4double gammaEnergy) const
 {
     // Geometric efficiency calculation for coaxial HPGe detector
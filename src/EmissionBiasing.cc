@@ -0,0 +1,102 @@
+// ==============================================================================
+// EmissionBiasing.cc - Importance sampling of primary emission directions
+// ==============================================================================
+
+#include "EmissionBiasing.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+
+const G4double EmissionBiasing::kDefaultFraction = 0.5;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EmissionBiasing* EmissionBiasing::Instance()
+{
+  static EmissionBiasing instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EmissionBiasing::EmissionBiasing()
+: fFraction(0.),
+  fHalfAngle(0.),
+  fCosHalfAngle(1.),
+  fConeWeight(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmissionBiasing::Configure(G4double fraction, const DetectorConstruction& detector)
+{
+  for (G4int k = 0; k < kNumberOfCones; k++) {
+    fAxes[k] = detector.GetDetectorAxis(k + 1);
+  }
+  fHalfAngle = detector.GetCollimatorHalfAngle();
+  fCosHalfAngle = std::cos(fHalfAngle);
+  fFraction = fraction;
+
+  // f times the density of a cone direction, (1 / nCones) / Omega, relative
+  // to 1 / 4pi
+  fConeWeight = fFraction * 4. / (kNumberOfCones * 2. * (1. - fCosHalfAngle));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EmissionBiasing::ChooseBiasedPrimary(G4int nPrimaries) const
+{
+  if (!IsActive() || nPrimaries <= 0 || G4UniformRand() >= fFraction) return -1;
+  G4int chosen = (G4int)(G4UniformRand() * nPrimaries);
+  return std::min(chosen, nPrimaries - 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector EmissionBiasing::SampleConeDirection() const
+{
+  G4int cone = std::min((G4int)(G4UniformRand() * kNumberOfCones), kNumberOfCones - 1);
+  G4double cosTheta = 1. - G4UniformRand() * (1. - fCosHalfAngle);
+  G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+  G4double phi = twopi*G4UniformRand();
+
+  G4ThreeVector direction(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+  direction.rotateUz(fAxes[cone]);
+  return direction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EmissionBiasing::ConesHolding(const G4ThreeVector& direction) const
+{
+  G4int inside = 0;
+  for (G4int k = 0; k < kNumberOfCones; k++) {
+    if (direction.dot(fAxes[k]) >= fCosHalfAngle) inside++;
+  }
+  return inside;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EmissionBiasing::EventWeight(G4int conesHeld, G4int nPrimaries) const
+{
+  if (!IsActive() || nPrimaries <= 0) return 1.;
+  return 1. / ((1. - fFraction) + conesHeld * fConeWeight / nPrimaries);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmissionBiasing::PrintConfiguration() const
+{
+  if (!IsActive()) return;
+
+  G4cout << "Emission biasing: one primary in " << fFraction * 100. << "% of the events drawn in "
+         << kNumberOfCones << " cones of " << fHalfAngle / deg
+         << " deg half-angle towards the collimators" << G4endl;
+  G4cout << "  event weight between " << 1. / ((1. - fFraction) + kNumberOfCones * fConeWeight)
+         << " and " << 1. / (1. - fFraction) << G4endl;
+}
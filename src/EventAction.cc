@@ -5,6 +5,8 @@
 #include "RunAction.hh"
 
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "Run.hh"
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
@@ -68,12 +70,17 @@ void EventAction::EndOfEventAction(const G4Event* event)
     bool det2Hit = (fEnergyDepositDet2 >= fMinimumEnergy);
     
     
+    // Statistical weight of the event: every row, histogram entry and sum
+    // counts with it, so biased emission still gives unbiased spectra
+    G4double weight = EventWeight(event);
+
     // Save all detector hits to ROOT using G4AnalysisManager
     if (det1Hit || det2Hit) {
         auto analysisManager = G4AnalysisManager::Instance();
         // Convert energies from MeV to keV
         analysisManager->FillNtupleDColumn(0, fEnergyDepositDet1 / keV);
         analysisManager->FillNtupleDColumn(1, fEnergyDepositDet2 / keV);
+        analysisManager->FillNtupleDColumn(2, weight);
         analysisManager->AddNtupleRow();
     }
 
@@ -82,22 +89,40 @@ void EventAction::EndOfEventAction(const G4Event* event)
     if (currentRun) {
         // Add single detector spectra
         if (det1Hit) {
-            currentRun->AddEnergySpectrumDet1(fEnergyDepositDet1);
+            currentRun->AddEnergySpectrumDet1(fEnergyDepositDet1, weight);
         }
         if (det2Hit) {
-            currentRun->AddEnergySpectrumDet2(fEnergyDepositDet2);
+            currentRun->AddEnergySpectrumDet2(fEnergyDepositDet2, weight);
         }
     }
     
     // Maintain compatibility with RunAction
-    fRunAction->AddEnergyDepositDet1(fEnergyDepositDet1);
-    fRunAction->AddEnergyDepositDet2(fEnergyDepositDet2);
+    fRunAction->AddEnergyDepositDet1(fEnergyDepositDet1, weight);
+    fRunAction->AddEnergyDepositDet2(fEnergyDepositDet2, weight);
     
     eventCounter++;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4double EventAction::EventWeight(const G4Event* event) const
+{
+    // Product of all vertex and primary weights; -bias-cones sets only the
+    // weight of the first vertex, which is bounded by 1/(1-f)
+    G4double weight = 1.;
+    for (G4int i = 0; i < event->GetNumberOfPrimaryVertex(); i++) {
+        const G4PrimaryVertex* vertex = event->GetPrimaryVertex(i);
+        weight *= vertex->GetWeight();
+        for (const G4PrimaryParticle* particle = vertex->GetPrimary(); particle;
+             particle = particle->GetNext()) {
+            weight *= particle->GetWeight();
+        }
+    }
+    return weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void EventAction::AddEnergyDeposit(G4double energy, G4int detectorID)
 {
     // Simple energy accumulation per detector (like original code)
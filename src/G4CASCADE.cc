@@ -19,73 +19,86 @@
  ********************************************************************************/
 
 #include "G4CASCADE.hh"
+#include "G4CASCADECatalog.hh"
+#include "CascadeFilter.hh"
+#include "G4RDAtomicTransitionManager.hh"
+#include <sstream>
 
 using namespace std;
 
-G4RDShellData* shellDat;
+namespace {
 
-G4CASCADE::G4CASCADE() { 
-  shellDat = new G4RDShellData;
-  shellDat->LoadData("/fluor/binding");
+//Atomic deexcitation engine shared by the generators of all threads; it keeps no per-call state
+const G4RDAtomicDeexcitation& AtomicDeexcitation()
+{
+  static const G4RDAtomicDeexcitation deexcitation;
+  return deexcitation;
 }
 
-G4CASCADE::~G4CASCADE() { }
+//Redraws allowed for a cascade that fails the criteria the level graph does not decide,
+//before the filter is taken to be one no cascade can meet
+const G4long kMaxFilterRetries = 100000;
 
-// Helper function to get CASCADE data directory with fallback paths
-G4String G4CASCADE::GetDataDirectory()
-{
-  // First, check environment variable
-  const char* envDir = std::getenv("CAPGAM_DATA_DIR");
-  if (envDir) {
-    return G4String(envDir);
-  }
+}
 
-  // Try fallback paths (relative to build directory)
-  std::vector<G4String> fallbackPaths = {
-    "../DualHPGe_local/CapGamData",     // Current project
-    "../DualHPGe/CapGamData",           // Original location
-    "./CapGamData",                      // Local directory
-    "../CapGamData"                      // Parent directory
-  };
-
-  for (const auto& path : fallbackPaths) {
-    std::ifstream test(path + "/17-36.bin");  // Test with Cl-36 data file
-    if (test.good()) {
-      test.close();
-      return path;
-    }
+G4CASCADE::G4CASCADE()
+: fLevels(nullptr), fLevelsZ(0), fLevelsA(0), fLevelHits(0),
+  fHasQCorrection(false), fQCorrection(0.),
+  fRelaxation(nullptr), fRelaxationZ(0),
+  fTabulatedRelaxation(false),
+  fPhotonEvaporation(nullptr),
+  fFilter(nullptr),
+  fConditional(nullptr),
+  fReachable(1.),
+  fConditionalWarned(false),
+  fOverflowWarned(false)
+{
+  for (G4int shell = 0; shell < 3; shell++) {
+    fChains[shell] = nullptr;
+    fChainsZ[shell] = 0;
   }
-
-  // No valid path found
-  G4cerr << "ERROR: Could not find CASCADE data directory!" << G4endl;
-  G4cerr << "       Set CAPGAM_DATA_DIR environment variable or ensure CapGamData exists." << G4endl;
-  return "";
 }
 
-G4ReactionProductVector* G4CASCADE::GetGammas(G4Fragment nucleus, G4bool UseRawExcitation, G4bool doUnplaced)
+G4CASCADE::~G4CASCADE()
 {
-  //Declare and initialize result vector, level data, excitation energy, and highestObtainableLevel
-  G4ReactionProductVector* theResult = new G4ReactionProductVector;
-  vector<vector<vector<G4double>>> levels = GetLevels(nucleus.GetZ_asInt(), nucleus.GetA_asInt());
-  G4double exciteE;
-
-  if(UseRawExcitation == 0) {
-    G4double maxLevel = 0;
+  delete fPhotonEvaporation;
+  delete fConditional;
+}
 
-    //find the top energy level
-    for(int c=0; c<(int)levels.size(); c++) {
-      if(levels[c][0][0] > maxLevel) {
-        maxLevel = levels[c][0][0];
-      }
-    }
+//Photon evaporation engine for continuum levels, created on first use
+G4PhotonEvaporation* G4CASCADE::GetPhotonEvaporation()
+{
+  if (!fPhotonEvaporation) {
+    fPhotonEvaporation = new G4PhotonEvaporation;
+    fPhotonEvaporation->SetICM( TRUE );
+  }
+  return fPhotonEvaporation;
+}
 
-    //set excitation energy to the top level without accounting for extra energy or not enough energy
-    exciteE = maxLevel;
+// Helper function to get CASCADE data directory with fallback paths
+G4String G4CASCADE::GetDataDirectory()
+{
+  return G4CASCADECatalog::Instance()->GetDataDirectory();
+}
 
-  }else {
-    exciteE = nucleus.GetExcitationEnergy();
+//Returns the cached level graph, going through the shared cache only when the isotope changes
+const G4CASCADELevelGraph* G4CASCADE::GetCachedLevels(G4int Z, G4int A)
+{
+  if (fLevels && Z == fLevelsZ && A == fLevelsA) {
+    fLevelHits++;
+    return fLevels;
+  }
+  fLevels = G4CASCADELevelCache::Instance()->GetLevelGraph(Z, A);
+  fLevelsZ = Z;
+  fLevelsA = A;
+  fHasQCorrection = false;
+  return fLevels;
+}
 
-    //Emma's Q value correction
+//Emma's Q value correction: top level minus the Q value estimated from ground state masses
+G4double G4CASCADE::GetQCorrection(const G4Fragment& nucleus)
+{
+  if (!fHasQCorrection) {
     G4double Product_GroundStateMass = nucleus.GetGroundStateMass();
     G4int isoZ = nucleus.GetZ_asInt();
     G4int isoA = nucleus.GetA_asInt();
@@ -94,201 +107,291 @@ G4ReactionProductVector* G4CASCADE::GetGammas(G4Fragment nucleus, G4bool UseRawE
     G4double Neutron_GroundStateMass = the_neutron.ComputeGroundStateMass(0,1);
     G4double Q_value_estimate = Neutron_GroundStateMass+Target_GroundStateMass-Product_GroundStateMass;
 
-    G4double maxLevel = 0;
+    fQCorrection = fLevels->LevelEnergy(fLevels->TopLevel()) - Q_value_estimate;
+    fHasQCorrection = true;
+  }
+  return fQCorrection;
+}
+
+G4ReactionProductVector* G4CASCADE::GetGammas(G4Fragment nucleus, G4bool UseRawExcitation, G4bool doUnplaced)
+{
+  //Thin wrapper for callers that want Geant4 reaction products
+  G4ReactionProductVector* theResult = new G4ReactionProductVector;
+  GenerateCascade(nucleus, UseRawExcitation, doUnplaced, fProductBuffer);
+
+  for(size_t i = 0; i < fProductBuffer.Size(); i++) {
+    const G4CASCADEParticle& particle = fProductBuffer[i];
+    G4double mass = particle.definition->GetPDGMass();
+    G4double p = std::sqrt(particle.energy * (particle.energy + 2.*mass));
+    G4ReactionProduct* product = new G4ReactionProduct;
+    product->SetDefinition( particle.definition );
+    product->SetMomentum( p * particle.direction );
+    theResult->push_back(product);
+  }
+  return theResult;
+}
 
-    //find the top energy level
-    for(int c=0; c<(int)levels.size(); c++) {
-      if(levels[c][0][0] > maxLevel) {
-        maxLevel = levels[c][0][0];
-      }
+size_t G4CASCADE::GenerateCascade(const G4Fragment& nucleus, G4bool UseRawExcitation,
+                                  G4bool doUnplaced, G4CASCADEBuffer& buffer)
+{
+  if (!fFilter) return GenerateOne(nucleus, UseRawExcitation, doUnplaced, buffer, 0);
+
+  //Branches are drawn conditioned on the filter; the sum window and continuum decays are
+  //only known once the cascade is finished, so those are checked here and redrawn if needed
+  const G4CASCADEConditional* conditional = GetConditional(nucleus.GetZ_asInt(), nucleus.GetA_asInt(), doUnplaced);
+  //A cascade failing the filter is never handed out: as for RAINIER input, a filter that
+  //nothing passes stops the run instead of giving one that looks valid but is unfiltered
+  size_t n = GenerateOne(nucleus, UseRawExcitation, doUnplaced, buffer, conditional);
+  G4long retries = 0;
+  while (!fFilter->Passes(fNuclearGammas.data(), fNuclearGammas.size(),
+                          fVisitedLevels.data(), fVisitedLevels.size())) {
+    if (fReachable <= 0. || retries >= kMaxFilterRetries) {
+      std::ostringstream message;
+      message << "No usable cascade: ";
+      if (fReachable <= 0.) message << "no";
+      else message << "none of " << retries + 1;
+      message << " CASCADE cascade" << (fReachable <= 0. ? "" : "s") << " of Z=" << nucleus.GetZ_asInt()
+              << " A=" << nucleus.GetA_asInt() << " passes the filter " << fFilter->GetDescription();
+      G4Exception("G4CASCADE::GenerateCascade()", "CASCADE001", FatalException, message.str().c_str());
+      buffer.Clear();
+      return 0;
     }
+    n = GenerateOne(nucleus, UseRawExcitation, doUnplaced, buffer, conditional);
+    retries++;
+  }
+  fFilter->RecordConditional(fReachable, retries);
+  return n;
+}
 
-    G4double Q_correction = maxLevel-Q_value_estimate;
-    exciteE += Q_correction;
-    //end correction
+//Hands the level-cache hits of this generator to the shared counters
+void G4CASCADE::FlushStatistics()
+{
+  if (fLevelHits == 0) return;
+  G4CASCADELevelCache::Instance()->RecordHits(fLevelHits);
+  fLevelHits = 0;
+}
 
-    G4double highestObtainableLevel = 0;
+//Conditional sampler of the cached level graph, built again when the isotope or doUnplaced changes
+const G4CASCADEConditional* G4CASCADE::GetConditional(G4int Z, G4int A, G4bool doUnplaced)
+{
+  if (!(fLevels && Z == fLevelsZ && A == fLevelsA)) GetCachedLevels(Z, A);
+  if (fConditional && &fConditional->GetGraph() == fLevels && fConditional->GetDoUnplaced() == doUnplaced)
+    return fConditional->IsValid() ? fConditional : 0;
+
+  delete fConditional;
+  fConditional = 0;
+  if (!fLevels) return 0;
+  fConditional = new G4CASCADEConditional(*fLevels, *fFilter, doUnplaced);
+  if (!fConditional->IsValid() && !fConditionalWarned) {
+    G4cerr << "WARNING: Cascade filter " << fFilter->GetDescription()
+           << " has too many criteria for conditional sampling; CASCADE cascades are drawn"
+           << " and rejected instead" << G4endl;
+    fConditionalWarned = true;
+  }
+  return fConditional->IsValid() ? fConditional : 0;
+}
+
+size_t G4CASCADE::GenerateOne(const G4Fragment& nucleus, G4bool UseRawExcitation,
+                              G4bool doUnplaced, G4CASCADEBuffer& buffer,
+                              const G4CASCADEConditional* conditional)
+{
+  //Declare and initialize level data, excitation energy, current level and emission step
+  buffer.Clear();
+  fNuclearGammas.clear();
+  fVisitedLevels.clear();
+  const G4CASCADELevelGraph* levels = GetCachedLevels(nucleus.GetZ_asInt(), nucleus.GetA_asInt());
+  if (!levels) {
+    G4cerr << "ERROR: No CASCADE level data for Z=" << nucleus.GetZ_asInt()
+           << " A=" << nucleus.GetA_asInt() << G4endl;
+    return 0;
+  }
+  G4int level;
+  G4double exciteE;
+  G4int order = 0;
+  G4int state = conditional ? conditional->InitialState() : 0;
+
+  if(UseRawExcitation == 0) {
+    //start at the top level without accounting for extra energy or not enough energy
+    level = levels->TopLevel();
+
+  }else {
+    exciteE = nucleus.GetExcitationEnergy() + GetQCorrection(nucleus);
 
     //find the highest energy level with energy less than the excitation energy
-    for(int c=0; c<(int)levels.size(); c++) {
-      if(levels[c][0][0] < exciteE and levels[c][0][0] > highestObtainableLevel) {
-        highestObtainableLevel = levels[c][0][0];
-      }
-    }
+    level = levels->HighestLevelBelow(exciteE);
 
     //release excess energy as a gamma, go to highest obtainable level
-    G4double excessE = exciteE - highestObtainableLevel;
-    G4ReactionProduct* excessGam = new G4ReactionProduct;
-    excessGam->SetDefinition( G4Gamma::Gamma() );
-    excessGam->SetMomentum( excessE*GetRandomDirection() );
-    theResult->push_back(excessGam);
-    exciteE = highestObtainableLevel;
+    G4double excessE = exciteE - levels->LevelEnergy(level);
+    buffer.Add(G4Gamma::Gamma(), excessE, GetRandomDirection(), ++order);
+    if(excessE > 0.) {
+      fNuclearGammas.push_back(excessE / MeV);
+      if(conditional) state = conditional->AfterGamma(state, excessE);
+    }
 
   }
-
-  G4int levelIndex;
-  G4double ground = 0;
+  fReachable = conditional ? conditional->PassProbability(level, state) : 1.;
 
   //until at ground state, randomly choose decay based on branching ratios
-  while(exciteE != ground) {
-    levelIndex = -1;
-    for(int c=0; c<(int)levels.size() and levelIndex == -1; c++) {
-      if(levels[c][0][0] == exciteE) {
-        levelIndex = c;
-      }
-    }
-    if(levels[levelIndex].size() == 2 and levels[levelIndex][1][2] == -3 * CLHEP::keV) {
+  while(level != G4CASCADELevelGraph::kGround) {
+    exciteE = levels->LevelEnergy(level);
+
+    if(levels->IsContinuum(level)) {
         //Photon Evaporation implementation taken from G4particleHPCaptureFS (and modified for this context)
-        G4PhotonEvaporation photonEvaporation;
-        photonEvaporation.SetICM( TRUE );
+        //The evaporation engine and its product vector live as long as the generator
+        G4PhotonEvaporation* photonEvaporation = GetPhotonEvaporation();
         G4LorentzVector nLV = nucleus.GetMomentum();
         G4ThreeVector n3m(nLV.getX(), nLV.getY(), nLV.getZ());
         G4LorentzVector temp(n3m, exciteE + nucleus.GetGroundStateMass());
-        nucleus.SetMomentum(temp);
-        G4FragmentVector* products = photonEvaporation.BreakItUp(nucleus);
+
+        //BreakUpChain as in G4PhotonEvaporation::BreakItUp, which would allocate
+        //the vector and a copy of the nucleus for the residual on every call
+        G4Fragment residual(nucleus);
+        residual.SetMomentum(temp);
+        fEvaporationProducts.clear();
+        photonEvaporation->BreakUpChain(&fEvaporationProducts, &residual);
+        fEvaporationProducts.push_back(&residual);
+
         G4FragmentVector::iterator it;
-        for(it=products->begin(); it!=products->end(); it++)
+        for(it=fEvaporationProducts.begin(); it!=fEvaporationProducts.end(); it++)
         {
-          G4ReactionProduct * theOne = new G4ReactionProduct;
+          const G4ParticleDefinition* definition = G4Gamma::Gamma();
           if ( (*it)->GetParticleDefinition() != 0 )
-            theOne->SetDefinition( (*it)->GetParticleDefinition() );
-          else
-            theOne->SetDefinition( G4Gamma::Gamma() ); // this definition will be over writen
+            definition = (*it)->GetParticleDefinition();
 
           G4IonTable* theTable = G4IonTable::GetIonTable();
           if ( (*it)->GetMomentum().mag() > 10*MeV)
-            theOne->SetDefinition(theTable->GetIon(nucleus.GetZ_asInt(), nucleus.GetA_asInt(), 0) );
+            definition = theTable->GetIon(nucleus.GetZ_asInt(), nucleus.GetA_asInt(), 0);
 
+          order++;
           if ( (*it)->GetExcitationEnergy() > 1.0e-2*eV) {
             G4double ex = (*it)->GetExcitationEnergy();
-            G4ReactionProduct* aPhoton = new G4ReactionProduct;
-            aPhoton->SetDefinition( G4Gamma::Gamma() );
-            aPhoton->SetMomentum( (*it)->GetMomentum().vect().unit() * ex );
-            theResult->push_back(aPhoton);
+            buffer.Add(G4Gamma::Gamma(), ex, (*it)->GetMomentum().vect().unit(), order);
+            fNuclearGammas.push_back(ex / MeV);
           }
 
-          theOne->SetMomentum( (*it)->GetMomentum().vect() * ( (*it)->GetMomentum().t() - (*it)->GetExcitationEnergy() ) / (*it)->GetMomentum().t() ) ;
-          theResult->push_back(theOne);
-          delete *it;
+          G4ThreeVector momentum = (*it)->GetMomentum().vect() * ( (*it)->GetMomentum().t() - (*it)->GetExcitationEnergy() ) / (*it)->GetMomentum().t();
+          G4double mass = definition->GetPDGMass();
+          G4double kineticE = std::sqrt(momentum.mag2() + mass*mass) - mass;
+          buffer.Add(definition, kineticE, momentum.unit(), order);
+          if (*it != &residual) delete *it;
         }
-        delete products;
-        exciteE = ground;
+        fEvaporationProducts.clear();
+        level = G4CASCADELevelGraph::kGround;
     }
     else {
-      vector<G4double> sumProbs;
-      G4double prev = 0;
-      for(int c=1; c<(int)levels[levelIndex].size(); c++) {
-        sumProbs.push_back(prev + levels[levelIndex][c][1]);
-        prev = sumProbs[c-1];
+      G4int transition = conditional ? conditional->SampleTransition(level, state, G4UniformRand())
+                                     : levels->SampleTransition(level, doUnplaced, G4UniformRand());
+      if(transition < 0) {
+        //no transition out of this level may be followed (e.g. only unplaced ones): stop here
+        break;
       }
-      G4double random = (G4UniformRand()) * sumProbs[sumProbs.size()-1];
-      for(int c=0; c<(int)sumProbs.size(); c++) {
-        if(random < sumProbs[c] and (levels[levelIndex][c+1][2] > 0 or doUnplaced)) {
-          if(levels[levelIndex][c+1][2] == 1 * CLHEP::keV or (levels[levelIndex][c+1][2] == -1 * CLHEP::keV and doUnplaced)) {
-            G4ReactionProduct* newGam = new G4ReactionProduct;
-            newGam->SetDefinition( G4Gamma::Gamma() );
-            newGam->SetMomentum( (exciteE - levels[levelIndex][c+1][0]) * GetRandomDirection() );
-            theResult->push_back(newGam);
-          }
-  	  if(levels[levelIndex][c+1][2] == 2 * CLHEP::keV or (levels[levelIndex][c+1][2] == -2 * CLHEP::keV and doUnplaced)) {
-	    G4ReactionProduct* newEl = new G4ReactionProduct;
-	    newEl->SetDefinition( G4Electron::Electron() );
-  	    G4RDAtomicDeexcitation* AtoDeex = new G4RDAtomicDeexcitation;
-  	    vector<G4DynamicParticle*>* ADGammas;
-	    G4double ICrand = (G4UniformRand());
-
-	    //Choose which shell to eject electron from based on constant percentages, do atomic deexcitation
-	    if(ICrand <= 0.893){
-	      ADGammas = AtoDeex->GenerateParticles(nucleus.GetZ_asInt(), 1);
-	      G4double E = (exciteE - levels[levelIndex][c+1][0] - shellDat->BindingEnergy(nucleus.GetZ_asInt(), 0));
-	      newEl->SetMomentum( sqrt((E * E) + (2 * 0.51*CLHEP::MeV * E)) * GetRandomDirection() );
-	    }
-	    else if(ICrand <= 0.982){
-	      ADGammas = AtoDeex->GenerateParticles(nucleus.GetZ_asInt(), 3);
-	      G4double E = (exciteE - levels[levelIndex][c+1][0] - shellDat->BindingEnergy(nucleus.GetZ_asInt(), 1));
-	      newEl->SetMomentum( sqrt((E * E) + (2 * 0.51*CLHEP::MeV * E)) * GetRandomDirection() );
-	    }
-	    else {
-	      ADGammas = AtoDeex->GenerateParticles(nucleus.GetZ_asInt(), 8);
-	      G4double E = (exciteE - levels[levelIndex][c+1][0] - shellDat->BindingEnergy(nucleus.GetZ_asInt(), 4));
-	      newEl->SetMomentum( sqrt((E * E) + (2 * 0.51*CLHEP::MeV * E)) * GetRandomDirection() );
-	    }
-	    theResult->push_back(newEl);
-	    for(int c2=0; c2<(int)ADGammas->size(); c2++){
-              G4ReactionProduct* ADGam = new G4ReactionProduct;
-              ADGam->SetDefinition(ADGammas->at(c2)->GetDefinition());
-              ADGam->SetMomentum(ADGammas->at(c2)->GetMomentum());
-              theResult->push_back(ADGam);
-            }
-	  }
-          exciteE = levels[levelIndex][c+1][0];
-	  bool found = false;
-	  int ind = 0;
-	  while(!found and exciteE != ground){
-	    if(levels[ind][0][0] == exciteE){
-	      found = true;
-	    }
-	    ind++;
-	  }
-	  if(!found and exciteE != ground){
-	    cout << "Error: transition " << levels[levelIndex][c+1][0] << " at level " << levels[levelIndex][0][0] << " does not go to an existing level, probably due to a typo in a manually edited level structure file." << endl;
-	  }
-          break;
+      if(conditional) state = conditional->NextState(state, transition);
+      G4int finalLevel = levels->Target(transition);
+      G4double transitionE = exciteE - levels->LevelEnergy(finalLevel);
+      order++;
+      if(finalLevel != G4CASCADELevelGraph::kGround) fVisitedLevels.push_back(levels->LevelEnergy(finalLevel) / MeV);
+
+      if(levels->Type(transition) == G4CASCADELevelGraph::kGamma) {
+        buffer.Add(G4Gamma::Gamma(), transitionE, GetRandomDirection(), order);
+        fNuclearGammas.push_back(transitionE / MeV);
+      }
+      if(levels->Type(transition) == G4CASCADELevelGraph::kConversion) {
+	G4double ICrand = (G4UniformRand());
+	const G4RDRelaxationTable* atom = GetRelaxationTable(nucleus.GetZ_asInt());
+	G4int shellId, shellIndex, shell;
+
+	//Choose which shell to eject electron from based on constant percentages, do atomic deexcitation
+	//with the shared engine into the recycled product vector
+	fAtomicProducts.clear();
+	if(ICrand <= 0.893){
+	  shellId = 1;
+	  shellIndex = 0;
+	  shell = 0;
+	}
+	else if(ICrand <= 0.982){
+	  shellId = 3;
+	  shellIndex = 1;
+	  shell = 1;
+	}
+	else {
+	  shellId = 8;
+	  shellIndex = 4;
+	  shell = 2;
+	}
+	G4double E = transitionE;
+	const G4RDRelaxationChains* chains = 0;
+	if(atom){
+	  if(fTabulatedRelaxation) chains = GetRelaxationChains(nucleus.GetZ_asInt(), shell, shellId);
+	  if(!chains) AtomicDeexcitation().GenerateParticles(*atom, shellId, fAtomicProducts);
+	  E -= atom->BindingEnergy(shellIndex);
+	}
+	buffer.Add(G4Electron::Electron(), E, GetRandomDirection(), order);
+	if(chains){
+	  //one draw selects the whole chain of X-rays
+	  G4int outcome = chains->Sample(G4UniformRand());
+	  for(G4int c2=0; c2<chains->NumberOfPhotons(outcome); c2++)
+	    buffer.Add(G4Gamma::Gamma(), chains->PhotonEnergy(outcome, c2), GetRandomDirection(), order);
+	}
+	for(size_t c2=0; c2<fAtomicProducts.size(); c2++){
+          buffer.Add(fAtomicProducts[c2]->GetDefinition(), fAtomicProducts[c2]->GetKineticEnergy(),
+                     fAtomicProducts[c2]->GetMomentumDirection(), order);
+          delete fAtomicProducts[c2];
         }
+        fAtomicProducts.clear();
       }
+      level = finalLevel;
     }
   }
 
-  return theResult;
+  if (buffer.Overflowed() && !fOverflowWarned) {
+    G4cerr << "WARNING: CASCADE output buffer full (" << buffer.Capacity()
+           << " particles) for Z=" << nucleus.GetZ_asInt() << " A=" << nucleus.GetA_asInt()
+           << "; the rest of the cascade was dropped" << G4endl;
+    fOverflowWarned = true;
+  }
+  return buffer.Size();
+}
+
+//Relaxation table of element Z from G4RDAtomicTransitionManager, looked up again only when Z changes
+const G4RDRelaxationTable* G4CASCADE::GetRelaxationTable(G4int Z)
+{
+  if (!fRelaxation || Z != fRelaxationZ) {
+    fRelaxation = G4RDAtomicTransitionManager::Instance()->RelaxationTable(Z);
+    fRelaxationZ = Z;
+  }
+  return fRelaxation;
+}
 
+//Whole-chain relaxation table of a vacancy in shellId, looked up again only when Z changes;
+//0 when the chains could not all be listed, in which case the stepwise sampler is used
+const G4RDRelaxationChains* G4CASCADE::GetRelaxationChains(G4int Z, G4int shell, G4int shellId)
+{
+  if (Z != fChainsZ[shell]) {
+    fChains[shell] = G4RDRelaxationChains::Get(Z, shellId);
+    fChainsZ[shell] = Z;
+  }
+  const G4RDRelaxationChains* chains = fChains[shell];
+  return (chains && chains->IsComplete()) ? chains : 0;
 }
 
 //Method to check if CASCADE has data for a particular isotope
 bool G4CASCADE::HasData(G4int Z, G4int A)
 {
-  G4String dataDir = GetDataDirectory();
-  if (dataDir.empty()) {
-    return false;
+  if (fLevels && Z == fLevelsZ && A == fLevelsA) {
+    return true;
   }
-  G4String name = dataDir + "/" + std::to_string(Z) + "-" + std::to_string(A) + ".bin";
-  ifstream f(name.c_str());
-  return f.good();
+  return G4CASCADECatalog::Instance()->HasIsotope(Z, A);
 }
 
-//method to retrieve level data from CapGamData directory
+//method to retrieve level data from CapGamData directory (sorted by level energy)
 vector<vector<vector<G4double>>> G4CASCADE::GetLevels(G4int Z, G4int A)
 {
-  vector<vector<vector<G4double>>> readVector;
-
-    G4String dataDir = GetDataDirectory();
-    if (dataDir.empty()) {
-      G4cerr << "ERROR: Cannot load CASCADE data - no valid data directory!" << G4endl;
-      return readVector;
-    }
-    std::ifstream file2(dataDir + "/" + std::to_string(Z) + "-" + std::to_string(A) + ".bin", std::ios::in | std::ios::binary);
-
-    if (file2.is_open()) {
-        size_t dim12, dim22, dim32;
-        file2.read(reinterpret_cast<char*>(&dim12), sizeof(size_t));
-        readVector.resize(dim12);
-
-        for (size_t i = 0; i < dim12; ++i) {
-            file2.read(reinterpret_cast<char*>(&dim22), sizeof(size_t));
-            readVector[i].resize(dim22);
-
-            for (size_t j = 0; j < dim22; ++j) {
-                file2.read(reinterpret_cast<char*>(&dim32), sizeof(size_t));
-                readVector[i][j].resize(dim32);
-                file2.read(reinterpret_cast<char*>(readVector[i][j].data()), dim32 * sizeof(double));
-            }
-        }
-
-        file2.close();
-    } else {
-        std::cerr << "Error: Could not open the file for reading." << std::endl;
-    }
-
-  return readVector;
+  const G4CASCADELevelGraph* levels = GetCachedLevels(Z, A);
+  if (!levels) {
+    std::cerr << "Error: Could not open the file for reading." << std::endl;
+    return vector<vector<vector<G4double>>>();
+  }
+  return levels->ToLevelScheme();
 }
 
 //Method to generate a G4ThreeVector with a random direction
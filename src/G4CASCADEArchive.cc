@@ -0,0 +1,242 @@
+// ==============================================================================
+// G4CASCADEArchive.cc - Memory-mapped single-file CapGamData archive
+// ==============================================================================
+
+#include "G4CASCADEArchive.hh"
+#include "G4CASCADELevelCache.hh"
+#include "G4CASCADELevelGraph.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern bool g_quietMode;
+
+namespace {
+
+const char kMagic[8] = { 'C', 'G', 'A', 'M', 'A', 'R', 'C', '\0' };
+const uint32_t kVersion = 1;
+const size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t);
+
+size_t Align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+}
+
+const char* const G4CASCADEArchive::kFileName = "CapGamData.arc";
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADEArchive::G4CASCADEArchive()
+: fData(nullptr),
+  fSize(0),
+  fNIsotopes(0),
+  fIndex(nullptr)
+{}
+
+G4CASCADEArchive::~G4CASCADEArchive()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4CASCADEArchive::Open(const G4String& path)
+{
+  Close();
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < kHeaderSize) {
+    close(fd);
+    G4cerr << "WARNING: " << path << " is not a valid CapGamData archive, ignoring it" << G4endl;
+    return false;
+  }
+
+  size_t size = st.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    G4cerr << "WARNING: Could not map " << path << ", ignoring it" << G4endl;
+    return false;
+  }
+
+  const char* bytes = static_cast<const char*>(data);
+  uint32_t version, nIsotopes;
+  std::memcpy(&version, bytes + sizeof(kMagic), sizeof(uint32_t));
+  std::memcpy(&nIsotopes, bytes + sizeof(kMagic) + sizeof(uint32_t), sizeof(uint32_t));
+
+  // The header, the index and every block it points at must lie in the file
+  G4bool valid = std::memcmp(bytes, kMagic, sizeof(kMagic)) == 0 && version == kVersion
+              && kHeaderSize + (size_t)nIsotopes * sizeof(IndexEntry) <= size;
+  const IndexEntry* index = reinterpret_cast<const IndexEntry*>(bytes + kHeaderSize);
+  for (uint32_t i = 0; valid && i < nIsotopes; i++) {
+    valid = index[i].offset % 8 == 0 && index[i].offset <= size
+         && index[i].size <= size - index[i].offset
+         && (i == 0 || std::make_pair(index[i-1].Z, index[i-1].A)
+                     < std::make_pair(index[i].Z, index[i].A));
+  }
+  if (!valid) {
+    munmap(data, size);
+    G4cerr << "WARNING: " << path << " is not a valid CapGamData archive (version "
+           << kVersion << " expected), ignoring it" << G4endl;
+    return false;
+  }
+
+  fData = bytes;
+  fSize = size;
+  fNIsotopes = nIsotopes;
+  fIndex = index;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADEArchive::Close()
+{
+  if (fData) {
+    munmap(const_cast<char*>(fData), fSize);
+  }
+  fData = nullptr;
+  fSize = 0;
+  fNIsotopes = 0;
+  fIndex = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADEArchive::GetIsotope(G4int index, G4int& Z, G4int& A) const
+{
+  Z = fIndex[index].Z;
+  A = fIndex[index].A;
+}
+
+G4int G4CASCADEArchive::FindEntry(G4int Z, G4int A) const
+{
+  if (!fIndex) return -1;
+  const IndexEntry* end = fIndex + fNIsotopes;
+  const IndexEntry* it = std::lower_bound(fIndex, end, std::make_pair(Z, A),
+    [](const IndexEntry& entry, const std::pair<G4int, G4int>& key) {
+      return std::make_pair((G4int)entry.Z, (G4int)entry.A) < key;
+    });
+  if (it == end || it->Z != Z || it->A != A) return -1;
+  return (G4int)(it - fIndex);
+}
+
+G4bool G4CASCADEArchive::Find(G4int Z, G4int A, const char*& block, size_t& size) const
+{
+  G4int entry = FindEntry(Z, A);
+  if (entry < 0) return false;
+  block = fData + fIndex[entry].offset;
+  size = fIndex[entry].size;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G4CASCADEArchive::Build(const G4String& dataDir, const G4String& outputPath)
+{
+  // Collect the Z-A.bin files of the directory
+  std::vector<std::pair<G4int, G4int>> isotopes;
+  DIR* dir = opendir(dataDir.c_str());
+  if (!dir) {
+    G4cerr << "ERROR: Cannot read CapGamData directory '" << dataDir << "'" << G4endl;
+    return -1;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    G4int Z, A;
+    char tail[8];
+    if (std::sscanf(entry->d_name, "%d-%d.%7s", &Z, &A, tail) == 3
+        && std::strcmp(tail, "bin") == 0) {
+      isotopes.push_back(std::make_pair(Z, A));
+    }
+  }
+  closedir(dir);
+  std::sort(isotopes.begin(), isotopes.end());
+
+  // Convert each file; the index is written once all block sizes are known
+  std::vector<IndexEntry> index;
+  std::vector<std::unique_ptr<G4CASCADELevelGraph>> graphs;
+  size_t offset = 0;
+  G4int nBad = 0;
+  for (size_t i = 0; i < isotopes.size(); i++) {
+    G4int Z = isotopes[i].first;
+    G4int A = isotopes[i].second;
+    G4String fileName = dataDir + "/" + std::to_string(Z) + "-" + std::to_string(A) + ".bin";
+    std::unique_ptr<G4CASCADELevelScheme> levels(G4CASCADELevelCache::ReadLevelFile(fileName));
+    if (!levels) {
+      G4cerr << "ERROR: Could not read " << fileName << G4endl;
+      nBad++;
+      continue;
+    }
+    std::unique_ptr<G4CASCADELevelGraph> graph(new G4CASCADELevelGraph(Z, A, *levels));
+
+    IndexEntry entry;
+    entry.Z = Z;
+    entry.A = A;
+    entry.offset = offset;   // relative to the first block for now
+    entry.size = graph->BlockSize();
+    index.push_back(entry);
+    offset = Align8(offset + graph->BlockSize());
+    graphs.push_back(std::move(graph));
+  }
+
+  // An archive without some isotopes would hide them from every later run
+  if (nBad > 0) {
+    G4cerr << "ERROR: " << nBad << " of " << isotopes.size()
+           << " CapGamData files could not be read; no archive written" << G4endl;
+    return -1;
+  }
+  if (index.empty()) {
+    G4cerr << "ERROR: No CapGamData files in '" << dataDir << "'" << G4endl;
+    return -1;
+  }
+  size_t blocksOffset = Align8(kHeaderSize + index.size() * sizeof(IndexEntry));
+  for (size_t i = 0; i < index.size(); i++) index[i].offset += blocksOffset;
+
+  // Write to a temporary file and move it into place, so that a running job
+  // never maps a half-written archive
+  G4String tmpPath = outputPath + ".tmp";
+  std::ofstream out(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    G4cerr << "ERROR: Cannot write '" << tmpPath << "'" << G4endl;
+    return -1;
+  }
+
+  const char padding[8] = { 0 };
+  uint32_t nIsotopes = index.size();
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+  out.write(reinterpret_cast<const char*>(&nIsotopes), sizeof(nIsotopes));
+  out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+  size_t written = kHeaderSize + index.size() * sizeof(IndexEntry);
+  for (size_t i = 0; i < graphs.size(); i++) {
+    out.write(padding, index[i].offset - written);
+    out.write(graphs[i]->Block(), graphs[i]->BlockSize());
+    written = index[i].offset + graphs[i]->BlockSize();
+  }
+  out.close();
+
+  if (!out || std::rename(tmpPath.c_str(), outputPath.c_str()) != 0) {
+    G4cerr << "ERROR: Failed to write CapGamData archive '" << outputPath << "'" << G4endl;
+    std::remove(tmpPath.c_str());
+    return -1;
+  }
+
+  if (!g_quietMode) {
+    G4cout << "CapGamData archive written: " << outputPath << " (" << nIsotopes
+           << " isotopes, " << written << " bytes)" << G4endl;
+  }
+  return (G4int)nIsotopes;
+}
@@ -0,0 +1,168 @@
+// ==============================================================================
+// G4CASCADECatalog.cc - Process-wide list of the available CapGam isotopes
+// ==============================================================================
+
+#include "G4CASCADECatalog.hh"
+#include "G4CASCADELevelCache.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include <dirent.h>
+
+extern bool g_quietMode;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADECatalog* G4CASCADECatalog::Instance()
+{
+  static G4CASCADECatalog instance;
+  return &instance;
+}
+
+G4CASCADECatalog::G4CASCADECatalog()
+{}
+
+G4CASCADECatalog::~G4CASCADECatalog()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4CASCADECatalog::Initialize()
+{
+  std::call_once(fLoaded, &G4CASCADECatalog::Load, this);
+  return !fDataDir.empty() && !fIsotopes.empty();
+}
+
+const G4String& G4CASCADECatalog::GetDataDirectory()
+{
+  Initialize();
+  return fDataDir;
+}
+
+const G4CASCADEArchive* G4CASCADECatalog::GetArchive()
+{
+  Initialize();
+  return fArchive.IsOpen() ? &fArchive : nullptr;
+}
+
+const std::vector<std::pair<G4int, G4int>>& G4CASCADECatalog::GetIsotopes()
+{
+  Initialize();
+  return fIsotopes;
+}
+
+G4bool G4CASCADECatalog::HasIsotope(G4int Z, G4int A)
+{
+  Initialize();
+  return std::binary_search(fIsotopes.begin(), fIsotopes.end(), std::make_pair(Z, A));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G4CASCADECatalog::GetTopLevelEnergy(G4int Z, G4int A)
+{
+  if (!HasIsotope(Z, A)) return 0.;
+  const G4CASCADELevelGraph* graph = G4CASCADELevelCache::Instance()->GetLevelGraph(Z, A);
+  return graph ? graph->LevelEnergy(graph->TopLevel()) : 0.;
+}
+
+void G4CASCADECatalog::ListIsotopes()
+{
+  if (!Initialize()) {
+    G4cout << "CASCADE catalog: no isotopes available" << G4endl;
+    return;
+  }
+
+  G4cout << "CASCADE isotopes in " << fDataDir
+         << (fArchive.IsOpen() ? " (archive)" : "") << ": " << fIsotopes.size() << G4endl;
+  G4cout << "     Z     A   Sn (top level, MeV)   levels" << G4endl;
+  for (const auto& isotope : fIsotopes) {
+    const G4CASCADELevelGraph* graph =
+      G4CASCADELevelCache::Instance()->GetLevelGraph(isotope.first, isotope.second);
+    if (!graph) continue;
+    G4cout << std::setw(6) << isotope.first << std::setw(6) << isotope.second
+           << std::setw(22) << std::fixed << std::setprecision(5)
+           << graph->LevelEnergy(graph->TopLevel())
+           << std::setw(9) << graph->NumberOfLevels() - 1 << G4endl;
+  }
+  G4cout << std::defaultfloat << std::setprecision(6);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADECatalog::Load()
+{
+  fDataDir = FindDataDirectory();
+  if (fDataDir.empty()) {
+    G4cerr << "ERROR: Could not find CASCADE data directory!" << G4endl;
+    G4cerr << "       Set CAPGAM_DATA_DIR environment variable or ensure CapGamData exists." << G4endl;
+    return;
+  }
+
+  if (fArchive.Open(fDataDir + "/" + G4CASCADEArchive::kFileName)) {
+    for (G4int i = 0; i < fArchive.NumberOfIsotopes(); i++) {
+      G4int Z, A;
+      fArchive.GetIsotope(i, Z, A);
+      fIsotopes.push_back(std::make_pair(Z, A));
+    }
+  }
+
+  // Loose Z-A.bin files, including any added after the archive was built
+  if (DIR* dir = opendir(fDataDir.c_str())) {
+    while (struct dirent* entry = readdir(dir)) {
+      G4int Z, A;
+      char tail[8];
+      if (std::sscanf(entry->d_name, "%d-%d.%7s", &Z, &A, tail) == 3
+          && std::strcmp(tail, "bin") == 0) {
+        fIsotopes.push_back(std::make_pair(Z, A));
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(fIsotopes.begin(), fIsotopes.end());
+  fIsotopes.erase(std::unique(fIsotopes.begin(), fIsotopes.end()), fIsotopes.end());
+
+  if (fIsotopes.empty()) {
+    G4cerr << "ERROR: No CASCADE level data found in " << fDataDir << G4endl;
+  } else if (!g_quietMode) {
+    G4cout << "CASCADE: " << fIsotopes.size() << " isotopes available in " << fDataDir
+           << (fArchive.IsOpen() ? " (memory-mapped archive)" : "") << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// CAPGAM_DATA_DIR, then fallback paths relative to the build directory
+G4String G4CASCADECatalog::FindDataDirectory()
+{
+  // First, check environment variable
+  const char* envDir = std::getenv("CAPGAM_DATA_DIR");
+  if (envDir) {
+    return G4String(envDir);
+  }
+
+  // Try fallback paths (relative to build directory)
+  std::vector<G4String> fallbackPaths = {
+    "../DualHPGe_local/CapGamData",     // Current project
+    "../DualHPGe/CapGamData",           // Original location
+    "./CapGamData",                      // Local directory
+    "../CapGamData"                      // Parent directory
+  };
+
+  for (const auto& path : fallbackPaths) {
+    std::ifstream test(path + "/17-36.bin");  // Test with Cl-36 data file
+    std::ifstream archive(path + "/" + G4CASCADEArchive::kFileName);
+    if (test.good() || archive.good()) {
+      return path;
+    }
+  }
+
+  // No valid path found
+  return "";
+}
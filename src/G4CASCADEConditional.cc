@@ -0,0 +1,151 @@
+// ==============================================================================
+// G4CASCADEConditional.cc - Cascade sampling conditioned on a CascadeFilter
+// ==============================================================================
+
+#include "G4CASCADEConditional.hh"
+#include "CascadeFilter.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADEConditional::G4CASCADEConditional(const G4CASCADELevelGraph& graph,
+                                           const CascadeFilter& filter, G4bool doUnplaced)
+: fGraph(graph),
+  fDoUnplaced(doUnplaced),
+  fMinMultiplicity(filter.GetMinMultiplicity()),
+  fMaxMultiplicity(filter.GetMaxMultiplicity()),
+  fCountCap(fMaxMultiplicity >= 0 ? fMaxMultiplicity + 1 : fMinMultiplicity),
+  fNBits((G4int)(filter.GetLines().size() + filter.GetLevels().size())),
+  fAllBits(0),
+  fNStates(0)
+{
+  G4int nLevels = graph.NumberOfLevels();
+  if (fNBits > 20 || (G4long)(fCountCap + 1) * nLevels << fNBits > kMaxTableSize) return;
+  fAllBits = (1 << fNBits) - 1;
+  fNStates = (fCountCap + 1) << fNBits;
+
+  // Bits 0 .. nLines-1 are the lines, the next ones the levels
+  G4int nLines = (G4int)filter.GetLines().size();
+  for (const CascadeFilter::Window& line : filter.GetLines()) {
+    fLineWindows.push_back(line.energy);
+    fLineWindows.push_back(line.tolerance);
+  }
+  fLevelBits.assign(nLevels, 0);
+  for (G4int level = 1; level < nLevels; level++) {
+    for (size_t i = 0; i < filter.GetLevels().size(); i++) {
+      if (filter.GetLevels()[i].Contains(graph.LevelEnergy(level) / MeV)) {
+        fLevelBits[level] |= 1 << (nLines + i);
+      }
+    }
+  }
+  fTransitionBits.assign(graph.NumberOfTransitions(), 0);
+  for (G4int level = 1; level < nLevels; level++) {
+    for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+      G4int target = graph.Target(t);
+      fTransitionBits[t] = fLevelBits[target];
+      if (graph.Type(t) != G4CASCADELevelGraph::kGamma) continue;
+      G4double E = (graph.LevelEnergy(level) - graph.LevelEnergy(target)) / MeV;
+      for (G4int i = 0; i < nLines; i++) {
+        if (filter.GetLines()[i].Contains(E)) fTransitionBits[t] |= 1 << i;
+      }
+    }
+  }
+
+  // S(level, state) from the ground state up: targets always lie below
+  fPass.assign((size_t)nLevels * fNStates, 0.);
+  for (G4int level = 0; level < nLevels; level++) {
+    G4double* pass = &fPass[(size_t)level * fNStates];
+    G4double sum = 0.;
+    if (level != G4CASCADELevelGraph::kGround && !graph.IsContinuum(level)) {
+      for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+        if (graph.Target(t) < level) sum += graph.EffectiveWeight(t, doUnplaced);
+      }
+    }
+
+    if (graph.IsContinuum(level) && level != G4CASCADELevelGraph::kGround) {
+      // Decided after the cascade is finished
+      std::fill(pass, pass + fNStates, 1.);
+    } else if (sum <= 0.) {
+      // Ground state, or a level where the cascade stops
+      for (G4int state = 0; state < fNStates; state++) pass[state] = Passes(state) ? 1. : 0.;
+    } else {
+      for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+        G4double w = graph.EffectiveWeight(t, doUnplaced);
+        if (w <= 0. || graph.Target(t) >= level) continue;
+        w /= sum;
+        const G4double* below = &fPass[(size_t)graph.Target(t) * fNStates];
+        for (G4int state = 0; state < fNStates; state++) {
+          pass[state] += w * below[NextState(state, t)];
+        }
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADEConditional::~G4CASCADEConditional()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4CASCADEConditional::Passes(G4int state) const
+{
+  G4int count = state >> fNBits;
+  return count >= fMinMultiplicity && (fMaxMultiplicity < 0 || count <= fMaxMultiplicity)
+      && (state & fAllBits) == fAllBits;
+}
+
+G4int G4CASCADEConditional::AddGamma(G4int state) const
+{
+  G4int count = std::min((state >> fNBits) + 1, fCountCap);
+  return (count << fNBits) | (state & fAllBits);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G4CASCADEConditional::AfterGamma(G4int state, G4double E) const
+{
+  state = AddGamma(state);
+  for (size_t i = 0; i < fLineWindows.size() / 2; i++) {
+    if (std::abs(E / MeV - fLineWindows[2*i]) <= fLineWindows[2*i+1]) state |= 1 << i;
+  }
+  return state;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G4CASCADEConditional::NextState(G4int state, G4int transition) const
+{
+  if (fGraph.Type(transition) == G4CASCADELevelGraph::kGamma) state = AddGamma(state);
+  return state | fTransitionBits[transition];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G4CASCADEConditional::SampleTransition(G4int level, G4int state, G4double u) const
+{
+  // Branches of one level are few, so a linear scan over the conditioned
+  // weights is cheaper than an alias table per level and state
+  G4int first = fGraph.FirstTransition(level);
+  G4int last = fGraph.FirstTransition(level+1);
+  G4double total = 0.;
+  for (G4int t = first; t < last; t++) {
+    if (fGraph.Target(t) >= level) continue;
+    total += fGraph.EffectiveWeight(t, fDoUnplaced) * PassProbability(fGraph.Target(t), NextState(state, t));
+  }
+  if (total <= 0.) return -1;
+
+  G4double x = u * total;
+  G4int chosen = -1;
+  for (G4int t = first; t < last; t++) {
+    if (fGraph.Target(t) >= level) continue;
+    G4double w = fGraph.EffectiveWeight(t, fDoUnplaced) * PassProbability(fGraph.Target(t), NextState(state, t));
+    if (w <= 0.) continue;
+    chosen = t;
+    if (x < w) break;
+    x -= w;
+  }
+  return chosen;
+}
@@ -0,0 +1,230 @@
+// ==============================================================================
+// G4CASCADEExact.cc - Exact cascade probabilities from a CapGam level graph
+// ==============================================================================
+
+#include "G4CASCADEExact.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADEExact::G4CASCADEExact(const G4CASCADELevelGraph& graph, G4bool doUnplaced)
+: fGraph(graph),
+  fDoUnplaced(doUnplaced),
+  fContinuumFraction(0.),
+  fDeadEndFraction(0.)
+{
+  G4int nLevels = graph.NumberOfLevels();
+  G4int nTransitions = graph.NumberOfTransitions();
+
+  // Normalized branch probabilities, from the same effective weights the
+  // alias tables sample
+  fBranching.assign(nTransitions, 0.);
+  for (G4int level = 1; level < nLevels; level++) {
+    G4double sum = 0.;
+    for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+      sum += graph.EffectiveWeight(t, doUnplaced);
+    }
+    if (sum <= 0.) continue;
+    for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+      fBranching[t] = graph.EffectiveWeight(t, doUnplaced) / sum;
+    }
+  }
+
+  PropagateFrom(graph.TopLevel(), fPopulation);
+
+  // Continuum levels decay through G4PhotonEvaporation, not their branches
+  fIntensity.assign(nTransitions, 0.);
+  for (G4int level = 1; level < nLevels; level++) {
+    if (graph.IsContinuum(level)) continue;
+    for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+      fIntensity[t] = fPopulation[level] * fBranching[t];
+    }
+  }
+
+  // Multiplicity: distribution of the gamma count carried down to each level.
+  // A cascade has at most one gamma per level it leaves.
+  std::vector<std::vector<G4double>> count(nLevels);
+  count[graph.TopLevel()].assign(1, 1.);
+  fMultiplicity.assign(1, 0.);
+  for (G4int level = graph.TopLevel(); level >= 1; level--) {
+    std::vector<G4double>& here = count[level];
+    if (here.empty()) continue;
+
+    G4double total = 0.;
+    for (G4double p : here) total += p;
+    if (graph.IsContinuum(level)) {
+      fContinuumFraction += total;
+    } else if (graph.SampleTransition(level, doUnplaced, 0.5) < 0) {
+      fDeadEndFraction += total;
+      if (fMultiplicity.size() < here.size()) fMultiplicity.resize(here.size(), 0.);
+      for (size_t k = 0; k < here.size(); k++) fMultiplicity[k] += here[k];
+    } else {
+      for (G4int t = graph.FirstTransition(level); t < graph.FirstTransition(level+1); t++) {
+        if (fBranching[t] <= 0. || graph.Target(t) >= level) continue;
+        size_t shift = (graph.Type(t) == G4CASCADELevelGraph::kGamma) ? 1 : 0;
+        std::vector<G4double>& below = count[graph.Target(t)];
+        if (below.size() < here.size() + shift) below.resize(here.size() + shift, 0.);
+        for (size_t k = 0; k < here.size(); k++) below[k + shift] += here[k] * fBranching[t];
+      }
+    }
+    std::vector<G4double>().swap(here);
+  }
+  const std::vector<G4double>& ground = count[G4CASCADELevelGraph::kGround];
+  if (fMultiplicity.size() < ground.size()) fMultiplicity.resize(ground.size(), 0.);
+  for (size_t k = 0; k < ground.size(); k++) fMultiplicity[k] += ground[k];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADEExact::~G4CASCADEExact()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADEExact::PropagateFrom(G4int start, std::vector<G4double>& reach) const
+{
+  reach.assign(fGraph.NumberOfLevels(), 0.);
+  reach[start] = 1.;
+  for (G4int level = start; level >= 1; level--) {
+    if (reach[level] == 0. || fGraph.IsContinuum(level)) continue;
+    for (G4int t = fGraph.FirstTransition(level); t < fGraph.FirstTransition(level+1); t++) {
+      // Transitions that do not go down would break the DAG order; the
+      // shipped data has none
+      if (fGraph.Target(t) >= level) continue;
+      reach[fGraph.Target(t)] += reach[level] * fBranching[t];
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4CASCADEExact::GammaPair> G4CASCADEExact::GammaPairs(G4double threshold) const
+{
+  std::vector<GammaPair> pairs;
+  std::vector<G4double> reach;
+  for (G4int first = 0; first < fGraph.NumberOfTransitions(); first++) {
+    if (fGraph.Type(first) != G4CASCADELevelGraph::kGamma) continue;
+    if (fIntensity[first] < threshold) continue;
+
+    // Every gamma line below the end level of the first one
+    G4int start = fGraph.Target(first);
+    PropagateFrom(start, reach);
+    for (G4int level = start; level >= 1; level--) {
+      if (reach[level] == 0. || fGraph.IsContinuum(level)) continue;
+      for (G4int t = fGraph.FirstTransition(level); t < fGraph.FirstTransition(level+1); t++) {
+        if (fGraph.Type(t) != G4CASCADELevelGraph::kGamma) continue;
+        G4double probability = fIntensity[first] * reach[level] * fBranching[t];
+        if (probability >= threshold) {
+          GammaPair pair = { first, t, probability };
+          pairs.push_back(pair);
+        }
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end(), [](const GammaPair& a, const GammaPair& b) {
+    return a.probability > b.probability;
+  });
+  return pairs;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4CASCADEExact::TwoGammaCascade> G4CASCADEExact::TwoGammaCascades() const
+{
+  std::vector<TwoGammaCascade> cascades;
+  G4int top = fGraph.TopLevel();
+  for (G4int first = fGraph.FirstTransition(top); first < fGraph.FirstTransition(top+1); first++) {
+    G4int level = fGraph.Target(first);
+    if (fBranching[first] <= 0. || fGraph.Type(first) != G4CASCADELevelGraph::kGamma) continue;
+    if (level == G4CASCADELevelGraph::kGround || fGraph.IsContinuum(level)) continue;
+    for (G4int t = fGraph.FirstTransition(level); t < fGraph.FirstTransition(level+1); t++) {
+      if (fGraph.Target(t) != G4CASCADELevelGraph::kGround) continue;
+      if (fBranching[t] <= 0. || fGraph.Type(t) != G4CASCADELevelGraph::kGamma) continue;
+      TwoGammaCascade cascade = { level, first, t, fBranching[first] * fBranching[t] };
+      cascades.push_back(cascade);
+    }
+  }
+  return cascades;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADEExact::WriteTable(std::ostream& out, G4double pairThreshold) const
+{
+  const G4CASCADELevelGraph& g = fGraph;
+  G4int top = g.TopLevel();
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+
+  out << "# Exact CASCADE probabilities for Z=" << g.GetZ() << " A=" << g.GetA()
+      << " (capture state " << std::fixed << std::setprecision(6) << g.LevelEnergy(top) / MeV
+      << " MeV, " << (fDoUnplaced ? "placed and unplaced" : "placed") << " transitions)\n";
+  out << "# All values per capture. Cascades reaching continuum levels: "
+      << std::scientific << std::setprecision(4) << fContinuumFraction
+      << ", ending at levels without followable branches: " << fDeadEndFraction << "\n";
+
+  // Lines, strongest first
+  std::vector<G4int> lines;
+  for (G4int t = 0; t < g.NumberOfTransitions(); t++) {
+    if (fIntensity[t] > 0.) lines.push_back(t);
+  }
+  std::sort(lines.begin(), lines.end(), [this](G4int a, G4int b) {
+    return fIntensity[a] > fIntensity[b];
+  });
+  out << "#\n# Lines: " << lines.size() << "\n";
+  out << "# " << std::left << std::setw(6) << "type" << std::setw(14) << "E(MeV)"
+      << std::setw(14) << "E_i(MeV)" << std::setw(14) << "E_f(MeV)" << "intensity\n";
+  // Level of each transition, by inverting the CSR offsets
+  std::vector<G4int> levelOf(g.NumberOfTransitions(), 0);
+  for (G4int level = 1; level < g.NumberOfLevels(); level++) {
+    for (G4int t = g.FirstTransition(level); t < g.FirstTransition(level+1); t++) levelOf[t] = level;
+  }
+  for (G4int t : lines) {
+    G4double Ei = g.LevelEnergy(levelOf[t]);
+    G4double Ef = g.LevelEnergy(g.Target(t));
+    const char* type = (g.Type(t) == G4CASCADELevelGraph::kGamma) ? "g"
+                     : (g.Type(t) == G4CASCADELevelGraph::kConversion) ? "e" : "?";
+    out << "  " << std::setw(6) << type << std::fixed << std::setprecision(6)
+        << std::setw(14) << (Ei - Ef) / MeV << std::setw(14) << Ei / MeV
+        << std::setw(14) << Ef / MeV << std::scientific << std::setprecision(6)
+        << fIntensity[t] << "\n";
+  }
+
+  out << "#\n# Gamma multiplicity\n# " << std::setw(6) << "n" << "probability\n";
+  for (size_t k = 0; k < fMultiplicity.size(); k++) {
+    if (fMultiplicity[k] <= 0.) continue;
+    out << "  " << std::setw(6) << k << std::scientific << std::setprecision(6)
+        << fMultiplicity[k] << "\n";
+  }
+
+  std::vector<TwoGammaCascade> cascades = TwoGammaCascades();
+  out << "#\n# Direct two-gamma cascades (capture -> level -> ground): " << cascades.size() << "\n";
+  out << "# " << std::setw(4) << "#" << std::setw(7) << "Level" << std::setw(13) << "E_int(MeV)"
+      << std::setw(13) << "g1(MeV)" << std::setw(13) << "g2(MeV)" << "BR\n";
+  for (size_t i = 0; i < cascades.size(); i++) {
+    const TwoGammaCascade& c = cascades[i];
+    G4double Eint = g.LevelEnergy(c.level);
+    out << "  " << std::setw(4) << i << std::setw(7) << c.level << std::fixed
+        << std::setprecision(6) << std::setw(13) << Eint / MeV
+        << std::setw(13) << (g.LevelEnergy(top) - Eint) / MeV
+        << std::setw(13) << Eint / MeV << std::scientific << c.probability << "\n";
+  }
+
+  std::vector<GammaPair> pairs = GammaPairs(pairThreshold);
+  out << "#\n# Gamma pairs in one cascade with probability >= " << std::scientific
+      << std::setprecision(1) << pairThreshold << ": " << pairs.size() << "\n";
+  out << "# " << std::setw(13) << "g1(MeV)" << std::setw(13) << "g2(MeV)" << "probability\n";
+  for (const GammaPair& p : pairs) {
+    G4double E1 = g.LevelEnergy(levelOf[p.first]) - g.LevelEnergy(g.Target(p.first));
+    G4double E2 = g.LevelEnergy(levelOf[p.second]) - g.LevelEnergy(g.Target(p.second));
+    out << "  " << std::fixed << std::setprecision(6) << std::setw(13) << E1 / MeV
+        << std::setw(13) << E2 / MeV << std::scientific << std::setprecision(6)
+        << p.probability << "\n";
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+}
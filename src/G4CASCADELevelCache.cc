@@ -0,0 +1,115 @@
+// ==============================================================================
+// G4CASCADELevelCache.cc - Process-wide cache of CapGam level schemes
+// ==============================================================================
+
+#include "G4CASCADELevelCache.hh"
+#include "G4CASCADECatalog.hh"
+#include "G4AutoLock.hh"
+#include <fstream>
+#include <memory>
+#include <string>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelCache* G4CASCADELevelCache::Instance()
+{
+  static G4CASCADELevelCache instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelCache::G4CASCADELevelCache()
+: fHits(0),
+  fMisses(0)
+{}
+
+G4CASCADELevelCache::~G4CASCADELevelCache()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4CASCADELevelGraph* G4CASCADELevelCache::GetLevelGraph(G4int Z, G4int A)
+{
+  G4int key = 1000*Z + A;
+
+  G4AutoLock lock(&fMutex);
+  auto it = fGraphs.find(key);
+  if (it != fGraphs.end()) {
+    fHits.fetch_add(1, std::memory_order_relaxed);
+    return it->second.get();
+  }
+
+  // First request for this isotope: load and validate it while holding the
+  // lock so that concurrent first use from several workers loads it only once
+  fMisses.fetch_add(1, std::memory_order_relaxed);
+  G4CASCADECatalog* catalog = G4CASCADECatalog::Instance();
+  if (!catalog->HasIsotope(Z, A)) {
+    fGraphs[key].reset();
+    return nullptr;
+  }
+
+  G4CASCADELevelGraph* graph = nullptr;
+  const G4CASCADEArchive* archive = catalog->GetArchive();
+  const char* block;
+  size_t size;
+  if (archive && archive->Find(Z, A, block, size)) {
+    graph = new G4CASCADELevelGraph(Z, A, block, size);
+    if (!graph->IsValid()) {
+      G4cerr << "WARNING: Corrupt entry for Z=" << Z << " A=" << A
+             << " in " << G4CASCADEArchive::kFileName << ", reading the .bin file" << G4endl;
+      delete graph;
+      graph = nullptr;
+    }
+  }
+  if (!graph) {
+    std::unique_ptr<G4CASCADELevelScheme> levels(ReadLevelFile(
+      catalog->GetDataDirectory() + "/" + std::to_string(Z) + "-" + std::to_string(A) + ".bin"));
+    if (levels) graph = new G4CASCADELevelGraph(Z, A, *levels);
+  }
+  fGraphs[key].reset(graph);
+  return graph;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADELevelCache::PrintStatistics() const
+{
+  G4long hits = GetHits();
+  G4long misses = GetMisses();
+  if (hits + misses == 0) return;
+
+  G4cout << "CASCADE level cache: " << hits << " hits, " << misses
+         << " misses (" << misses << " level scheme file"
+         << (misses == 1 ? "" : "s") << " read)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Reads a CapGamData .bin file; returns nullptr if the file cannot be opened
+G4CASCADELevelScheme* G4CASCADELevelCache::ReadLevelFile(const G4String& fileName)
+{
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    return nullptr;
+  }
+
+  G4CASCADELevelScheme* readVector = new G4CASCADELevelScheme;
+  size_t dim1, dim2, dim3;
+  file.read(reinterpret_cast<char*>(&dim1), sizeof(size_t));
+  readVector->resize(dim1);
+
+  for (size_t i = 0; i < dim1; ++i) {
+    file.read(reinterpret_cast<char*>(&dim2), sizeof(size_t));
+    (*readVector)[i].resize(dim2);
+
+    for (size_t j = 0; j < dim2; ++j) {
+      file.read(reinterpret_cast<char*>(&dim3), sizeof(size_t));
+      (*readVector)[i][j].resize(dim3);
+      file.read(reinterpret_cast<char*>((*readVector)[i][j].data()), dim3 * sizeof(double));
+    }
+  }
+
+  file.close();
+  return readVector;
+}
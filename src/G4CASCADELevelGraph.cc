@@ -0,0 +1,323 @@
+// ==============================================================================
+// G4CASCADELevelGraph.cc - Flat, index-based CapGam level scheme
+// ==============================================================================
+
+#include "G4CASCADELevelGraph.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <set>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+
+// Block header: nLevels, nTransitions, Z, A
+const size_t kBlockHeaderSize = 4 * sizeof(G4int);
+
+size_t Align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelGraph::Layout::Layout(G4int nLevels, G4int nTransitions)
+{
+  size_t nL = nLevels;
+  size_t nT = nTransitions;
+  size_t offset = kBlockHeaderSize;
+  levelEnergy = offset;      offset = Align8(offset + nL * sizeof(G4double));
+  firstTransition = offset;  offset = Align8(offset + (nL + 1) * sizeof(G4int));
+  continuum = offset;        offset = Align8(offset + nL);
+  target = offset;           offset = Align8(offset + nT * sizeof(G4int));
+  flag = offset;             offset = Align8(offset + nT * sizeof(G4int));
+  probability = offset;      offset = Align8(offset + nT * sizeof(G4double));
+  for (int i = 0; i < 2; i++) {
+    weight[i] = offset;      offset = Align8(offset + nT * sizeof(G4double));
+    cut[i] = offset;         offset = Align8(offset + nT * sizeof(G4double));
+    alias[i] = offset;       offset = Align8(offset + nT * sizeof(G4int));
+    followable[i] = offset;  offset = Align8(offset + nL);
+  }
+  size = offset;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelGraph::G4CASCADELevelGraph(G4int Z, G4int A,
+                                         const G4CASCADELevelScheme& levels)
+: fZ(Z),
+  fA(A),
+  fNLevels(0),
+  fNTransitions(0),
+  fBlock(nullptr),
+  fBlockSize(0)
+{
+  // Order the file's levels by energy. A level energy that appears twice is
+  // resolved to its first occurrence in the file, which is the one the
+  // original linear search found.
+  std::vector<G4int> order;
+  std::set<G4double> seenEnergies;
+  for (G4int c = 0; c < (G4int)levels.size(); c++) {
+    if (levels[c].empty() || levels[c][0].empty()) continue;
+    G4double energy = levels[c][0][0];
+    if (energy <= 0.) continue;
+    if (seenEnergies.insert(energy).second) {
+      order.push_back(c);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&levels](G4int a, G4int b) {
+    return levels[a][0][0] < levels[b][0][0];
+  });
+
+  std::map<G4double, G4int> indexByEnergy;
+  std::vector<G4double> levelEnergy(1, 0.);
+  for (G4int c : order) {
+    indexByEnergy[levels[c][0][0]] = (G4int)levelEnergy.size();
+    levelEnergy.push_back(levels[c][0][0]);
+  }
+
+  // Resolve every transition to the index of its final level once, here,
+  // instead of searching for it after each step of every cascade
+  G4int nDangling = 0;
+  std::vector<G4int> firstTransition(2, 0);   // the ground state has no transitions
+  std::vector<char> continuum(1, 0);
+  std::vector<G4int> target, flag;
+  std::vector<G4double> probability;
+  for (G4int c : order) {
+    const std::vector<std::vector<G4double>>& level = levels[c];
+    for (size_t t = 1; t < level.size(); t++) {
+      const std::vector<G4double>& transition = level[t];
+      if (transition.size() < 2) continue;
+
+      G4int finalLevel = kGround;
+      if (transition[0] != 0.) {
+        auto it = indexByEnergy.find(transition[0]);
+        if (it == indexByEnergy.end()) {
+          nDangling++;
+          G4cerr << "G4CASCADE: Z=" << fZ << " A=" << fA << " transition "
+                 << transition[0] << " at level " << level[0][0]
+                 << " does not go to an existing level, probably due to a typo"
+                 << " in a manually edited level structure file. Ignoring it." << G4endl;
+          continue;
+        }
+        finalLevel = it->second;
+      }
+
+      target.push_back(finalLevel);
+      flag.push_back((transition.size() > 2)
+                     ? (G4int)std::lround(transition[2] / CLHEP::keV) : kUnknown);
+      probability.push_back(transition[1]);
+    }
+    G4int first = firstTransition.back();
+    G4int nTransitions = (G4int)target.size() - first;
+    continuum.push_back(nTransitions == 1 && flag[first] == -kContinuum);
+    firstTransition.push_back((G4int)target.size());
+  }
+
+  if (nDangling > 0) {
+    G4cerr << "G4CASCADE: " << nDangling << " dangling transition(s) removed from Z="
+           << fZ << " A=" << fA << G4endl;
+  }
+
+  // Pack everything into one block, the same layout the archive stores
+  G4int nLevels = (G4int)levelEnergy.size();
+  G4int nTransitions = (G4int)target.size();
+  Layout layout(nLevels, nTransitions);
+  fOwnedBlock.assign(layout.size / sizeof(G4double), 0.);
+  char* block = reinterpret_cast<char*>(fOwnedBlock.data());
+
+  G4int header[4] = { nLevels, nTransitions, Z, A };
+  std::memcpy(block, header, sizeof(header));
+  std::memcpy(block + layout.levelEnergy, levelEnergy.data(), nLevels * sizeof(G4double));
+  std::memcpy(block + layout.firstTransition, firstTransition.data(), (nLevels + 1) * sizeof(G4int));
+  std::memcpy(block + layout.continuum, continuum.data(), nLevels);
+  std::memcpy(block + layout.target, target.data(), nTransitions * sizeof(G4int));
+  std::memcpy(block + layout.flag, flag.data(), nTransitions * sizeof(G4int));
+  std::memcpy(block + layout.probability, probability.data(), nTransitions * sizeof(G4double));
+
+  for (int i = 0; i < 2; i++) {
+    BuildAliasTable(nLevels, firstTransition.data(), flag.data(), probability.data(),
+                    i == 1,
+                    reinterpret_cast<G4double*>(block + layout.weight[i]),
+                    reinterpret_cast<G4double*>(block + layout.cut[i]),
+                    reinterpret_cast<G4int*>(block + layout.alias[i]),
+                    block + layout.followable[i]);
+  }
+
+  Attach(block, layout.size);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelGraph::G4CASCADELevelGraph(G4int Z, G4int A, const char* block, size_t size)
+: fZ(Z),
+  fA(A),
+  fNLevels(0),
+  fNTransitions(0),
+  fBlock(nullptr),
+  fBlockSize(0)
+{
+  Attach(block, size);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelGraph::~G4CASCADELevelGraph()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADELevelGraph::Attach(const char* block, size_t size)
+{
+  if (size < kBlockHeaderSize || reinterpret_cast<uintptr_t>(block) % 8 != 0) return;
+
+  G4int header[4];
+  std::memcpy(header, block, sizeof(header));
+  G4int nLevels = header[0];
+  G4int nTransitions = header[1];
+  if (nLevels < 1 || nTransitions < 0 || header[2] != fZ || header[3] != fA) return;
+
+  Layout layout(nLevels, nTransitions);
+  if (layout.size > size) return;
+
+  const G4int* firstTransition = reinterpret_cast<const G4int*>(block + layout.firstTransition);
+  const G4int* target = reinterpret_cast<const G4int*>(block + layout.target);
+  if (firstTransition[0] != 0 || firstTransition[nLevels] != nTransitions) return;
+  for (G4int level = 0; level < nLevels; level++) {
+    if (firstTransition[level+1] < firstTransition[level]) return;
+  }
+  for (G4int t = 0; t < nTransitions; t++) {
+    if (target[t] < 0 || target[t] >= nLevels) return;
+  }
+
+  fBlock = block;
+  fBlockSize = layout.size;
+  fLevelEnergy = reinterpret_cast<const G4double*>(block + layout.levelEnergy);
+  fFirstTransition = firstTransition;
+  fContinuum = block + layout.continuum;
+  fTarget = target;
+  fFlag = reinterpret_cast<const G4int*>(block + layout.flag);
+  fProbability = reinterpret_cast<const G4double*>(block + layout.probability);
+
+  AliasTable* tables[2] = { &fAliasPlaced, &fAliasAll };
+  for (int i = 0; i < 2; i++) {
+    tables[i]->weight = reinterpret_cast<const G4double*>(block + layout.weight[i]);
+    tables[i]->cut = reinterpret_cast<const G4double*>(block + layout.cut[i]);
+    tables[i]->alias = reinterpret_cast<const G4int*>(block + layout.alias[i]);
+    tables[i]->followable = block + layout.followable[i];
+  }
+
+  fNLevels = nLevels;
+  fNTransitions = nTransitions;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4CASCADELevelGraph::BuildAliasTable(G4int nLevels, const G4int* firstTransition,
+                                          const G4int* flag, const G4double* probability,
+                                          G4bool doUnplaced, G4double* weight, G4double* cut,
+                                          G4int* alias, char* followable)
+{
+  std::vector<G4double> scaled;
+  std::vector<G4int> small, large;
+
+  for (G4int level = 0; level < nLevels; level++) {
+    G4int first = firstTransition[level];
+    G4int n = firstTransition[level+1] - first;
+    followable[level] = 0;
+    if (n == 0) continue;
+
+    // A transition that is not followed keeps a zero weight and hands its
+    // probability to the next followed transition of the same level; mass
+    // behind the last followed transition is dropped (the original redrew).
+    G4double sum = 0.;
+    G4double pending = 0.;
+    for (G4int t = first; t < first + n; t++) {
+      pending += probability[t];
+      weight[t] = 0.;
+      cut[t] = 0.;
+      alias[t] = t;
+      if (flag[t] > 0 || doUnplaced) {
+        weight[t] = pending;
+        sum += pending;
+        pending = 0.;
+      }
+    }
+    if (sum <= 0.) continue;
+    followable[level] = 1;
+
+    // Vose's construction: split the n scaled weights into columns of
+    // height one, each holding at most two transitions
+    scaled.resize(n);
+    small.clear();
+    large.clear();
+    for (G4int i = 0; i < n; i++) {
+      scaled[i] = weight[first + i] * n / sum;
+      (scaled[i] < 1. ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      G4int s = small.back(); small.pop_back();
+      G4int l = large.back();
+      cut[first + s] = scaled[s];
+      alias[first + s] = first + l;
+      scaled[l] -= 1. - scaled[s];
+      if (scaled[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // Whatever is left is one up to rounding. A zero-weight leftover must
+    // never be returned, so it points at a transition that carries weight.
+    G4int heaviest = first;
+    for (G4int t = first; t < first + n; t++) {
+      if (weight[t] > weight[heaviest]) heaviest = t;
+    }
+    for (G4int i : large) {
+      cut[first + i] = 1.;
+      alias[first + i] = first + i;
+    }
+    for (G4int i : small) {
+      G4bool hasWeight = weight[first + i] > 0.;
+      cut[first + i] = hasWeight ? 1. : 0.;
+      alias[first + i] = hasWeight ? first + i : heaviest;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelGraph::TransitionType G4CASCADELevelGraph::Type(G4int transition) const
+{
+  G4int flag = std::abs(fFlag[transition]);
+  if (flag == kGamma || flag == kConversion || flag == kContinuum) {
+    return (TransitionType)flag;
+  }
+  return kUnknown;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G4CASCADELevelGraph::HighestLevelBelow(G4double E) const
+{
+  const G4double* it = std::lower_bound(fLevelEnergy + 1, fLevelEnergy + fNLevels, E);
+  return (G4int)(it - fLevelEnergy) - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4CASCADELevelScheme G4CASCADELevelGraph::ToLevelScheme() const
+{
+  G4CASCADELevelScheme levels;
+  for (G4int level = 1; level < NumberOfLevels(); level++) {
+    std::vector<std::vector<G4double>> entry;
+    entry.push_back(std::vector<G4double>(1, fLevelEnergy[level]));
+    for (G4int t = fFirstTransition[level]; t < fFirstTransition[level+1]; t++) {
+      entry.push_back({fLevelEnergy[fTarget[t]], fProbability[t], fFlag[t] * CLHEP::keV});
+    }
+    levels.push_back(entry);
+  }
+  return levels;
+}
@@ -35,6 +35,9 @@
 //  
 //  16 Sept 2001  First committed to cvs
 //  12 Sep  2003  Bug in auger production fixed
+//  16 Oct 2026   Radiative transitions sampled from G4RDRelaxationTable
+//  16 Oct 2026   Stateless: configuration fixed at construction, no
+//                per-call data members, so one instance can be shared
 //
 // -------------------------------------------------------------------
 
@@ -47,95 +50,76 @@ using namespace std;
 #include "G4RDAtomicTransitionManager.hh"
 #include "G4RDFluoTransition.hh"
 
-G4RDAtomicDeexcitation::G4RDAtomicDeexcitation():
-  minGammaEnergy(100.*CLHEP::eV),
-  minElectronEnergy(100.*CLHEP::eV),
-  fAuger(false)
+G4RDAtomicDeexcitation::G4RDAtomicDeexcitation(G4bool augerProduction,
+                                               G4double cutForSecondaryPhotons,
+                                               G4double cutForAugerElectrons):
+  minGammaEnergy(cutForSecondaryPhotons),
+  minElectronEnergy(cutForAugerElectrons),
+  fAuger(augerProduction)
 {}
 
 G4RDAtomicDeexcitation::~G4RDAtomicDeexcitation()
 {}
 
-std::vector<G4DynamicParticle*>* G4RDAtomicDeexcitation::GenerateParticles(G4int Z,G4int givenShellId)
+std::vector<G4DynamicParticle*>* G4RDAtomicDeexcitation::GenerateParticles(G4int Z,G4int givenShellId) const
 { 
+  std::vector<G4DynamicParticle*>* vectorOfParticles = new std::vector<G4DynamicParticle*>;
+  GenerateParticles(Z, givenShellId, *vectorOfParticles);
+  return vectorOfParticles;
+}
 
-  std::vector<G4DynamicParticle*>* vectorOfParticles;
-  
-  vectorOfParticles = new std::vector<G4DynamicParticle*>;
+void G4RDAtomicDeexcitation::GenerateParticles(G4int Z, G4int givenShellId,
+                                               std::vector<G4DynamicParticle*>& particles) const
+{
+  const G4RDRelaxationTable* table = 
+        G4RDAtomicTransitionManager::Instance()->RelaxationTable(Z);
+  if (!table)
+    {
+      G4cout << "G4RDAtomicDeexcitation warning: No fluorescence or Auger for Z=" << Z << G4endl;
+      G4cout << "Absorbed enrgy deposited locally" << G4endl;
+      return;
+    }
+  GenerateParticles(*table, givenShellId, particles);
+}
+
+void G4RDAtomicDeexcitation::GenerateParticles(const G4RDRelaxationTable& table, 
+                                               G4int givenShellId,
+                                               std::vector<G4DynamicParticle*>& particles) const
+{
+  G4int Z = table.GetZ();
+  G4int shellId = givenShellId;
+  G4int newShellId = 0;
   G4DynamicParticle* aParticle;
-  G4int provShellId = 0;
-  G4int counter = 0;
 
-  
   // The aim of this loop is to generate more than one fluorecence photon 
-  // from the same ionizing event 
+  // from the same ionizing event: givenShellId is given by the process,
+  // the following vacancies by GenerateFluorescence(...) or GenerateAuger(...)
   do
     {
-      if (counter == 0) 
-	// First call to GenerateParticles(...):
-	// givenShellId is given by the process
-	{
-	  provShellId = SelectTypeOfTransition(Z, givenShellId);
-	  //std::cout << "AtomicDeexcitation::Generate counter 0 - provShellId = "
-	  //<< provShellId << std::endl;
+      G4int line = SelectTypeOfTransition(table, shellId);
 
-	  if  ( provShellId >0) 
-	    {
-	      aParticle = GenerateFluorescence(Z,givenShellId,provShellId);  
-	      //std::cout << "AtomicDeexcitation::Generate Fluo counter 0 " << std::endl;
-	    }
-	  else if ( provShellId == -1)
-	    {
-	      aParticle = GenerateAuger(Z, givenShellId);
-	      //std::cout << "AtomicDeexcitation::Generate Auger counter 0 " << std::endl;
-	    }
-	  else
-	    {
-	      G4Exception("G4RDAtomicDeexcitation::GenerateParticles()",
-                          "InvalidSetup", FatalException,
-                          "Starting shell uncorrect: check it!");
-	    }
+      if (line >= 0) 
+	{
+	  aParticle = GenerateFluorescence(table, line, newShellId);
 	}
-      else 
-	// Following calls to GenerateParticles(...):
-	// newShellId is given by GenerateFluorescence(...)
+      else
 	{
-	  provShellId = SelectTypeOfTransition(Z,newShellId);
-	  //std::cout << "AtomicDeexcitation::Generate counter 0 - provShellId = "
-	  //<< provShellId << ", new ShellId = "<< newShellId
-	  //<< std::endl;
-
-
-	  if  (provShellId >0)
-	    {
-	      aParticle = GenerateFluorescence(Z,newShellId,provShellId);
-	      //std::cout << "AtomicDeexcitation::Generate Fluo " << std::endl;
-	    }
-	  else if ( provShellId == -1)
-	    {
-	      aParticle = GenerateAuger(Z, newShellId);
-	      //std::cout << "AtomicDeexcitation::Generate Auger " << std::endl;
-	    }
-	  else
-	    {
-	      G4Exception("G4RDAtomicDeexcitation::GenerateParticles()",
-                          "InvalidSetup", FatalException,
-                          "Starting shell uncorrect: check it!");
-	    }
+	  // the control is passed to the Auger generation part of the package 
+	  aParticle = GenerateAuger(Z, shellId, newShellId);
+	}
+      if (aParticle != 0) 
+	{
+	  particles.push_back(aParticle);
+	  shellId = newShellId;
 	}
-      counter++;
-      if (aParticle != 0) {vectorOfParticles->push_back(aParticle);}
-      else {provShellId = -2;}
     }
   
   // Look this in a particular way: only one auger emitted! //
-  while (provShellId > -2); 
-  
-
-  return vectorOfParticles;
+  while (aParticle != 0); 
 }
 
-G4int G4RDAtomicDeexcitation::SelectTypeOfTransition(G4int Z, G4int shellId)
+G4int G4RDAtomicDeexcitation::SelectTypeOfTransition(const G4RDRelaxationTable& table, 
+						     G4int shellId) const
 {
   if (shellId <=0 ) 
     {
@@ -144,80 +128,21 @@ G4int G4RDAtomicDeexcitation::SelectTypeOfTransition(G4int Z, G4int shellId)
                   "Zero or negative shellId!");
     }
 
-  const G4RDAtomicTransitionManager*  transitionManager = 
-        G4RDAtomicTransitionManager::Instance();
-  G4int provShellId = -1;
-  G4int shellNum = 0;
-  G4int maxNumOfShells = transitionManager->NumberOfReachableShells(Z);  
-  
-  //std::cout << "AtomicDeexcitation::SelectType -  NumberOfReachableShells = "
-  //<< maxNumOfShells<< std::endl;
-
-  const G4RDFluoTransition* refShell = transitionManager->ReachableShell(Z,maxNumOfShells-1);
+  // Index of shellId among the shells reachable through a radiative
+  // transition; -1 above the last of them
+  G4int vacancy = table.Vacancy(shellId);
+  if (vacancy < 0) return -1;
 
-  // This loop gives shellNum the value of the index of shellId
-  // in the vector storing the list of the shells reachable through
-  // a radiative transition
-  if ( shellId <= refShell->FinalShellId())
-    {
-      while (shellId != transitionManager->ReachableShell(Z,shellNum)->FinalShellId())
-	{
-	  if(shellNum ==maxNumOfShells-1)
-	    {
-	      break;
-	    }
-	  shellNum++;
-	}
-      G4int transProb = 0; //AM change 29/6/07 was 1
-   
-      G4double partialProb = (G4UniformRand());      
-      G4double partSum = 0;
-      const G4RDFluoTransition* aShell = transitionManager->ReachableShell(Z,shellNum);      
-      G4int trSize =  (aShell->TransitionProbabilities()).size();
-    
-      // Loop over the shells wich can provide an electron for a 
-      // radiative transition towards shellId:
-      // in every loop the partial sum of the first transProb shells
-      // is calculated and compared with a random number [0,1].
-      // If the partial sum is greater, the shell whose index is transProb
-      // is chosen as the starting shell for a radiative transition
-      // and its identity is returned
-      // Else, terminateded the loop, -1 is returned
-      while(transProb < trSize){
-	 partSum += aShell->TransitionProbability(transProb);
-
-	 if(partialProb <= partSum)
-	   {
-	     provShellId = aShell->OriginatingShellId(transProb);
-	     break;
-	   }
-	 transProb++;
-      }
-
-      // here provShellId is the right one or is -1.
-      // if -1, the control is passed to the Auger generation part of the package 
-    }
-
-
-
-  else 
-    {
- 
-     provShellId = -1;
-
-    }
-  return provShellId;
+  // The first line whose cumulative probability reaches a random number
+  // in [0,1] is the radiative transition; if there is none, -1 is
+  // returned and the vacancy is filled by a non-radiative transition
+  return table.SampleLine(vacancy, G4UniformRand());
 }
 
-G4DynamicParticle* G4RDAtomicDeexcitation::GenerateFluorescence(G4int Z, 
-							      G4int shellId,
-							      G4int provShellId )
+G4DynamicParticle* G4RDAtomicDeexcitation::GenerateFluorescence(const G4RDRelaxationTable& table, 
+							      G4int line,
+							      G4int& newShellId) const
 { 
-
-
-  const G4RDAtomicTransitionManager*  transitionManager = G4RDAtomicTransitionManager::Instance();
-  //  G4int provenienceShell = provShellId;
-
   //isotropic angular distribution for the outcoming photon
   G4double newcosTh = 1.-2.*(G4UniformRand());
   G4double  newsinTh = std::sqrt(1.-newcosTh*newcosTh);
@@ -229,45 +154,12 @@ G4DynamicParticle* G4RDAtomicDeexcitation::GenerateFluorescence(G4int Z,
   
   G4ThreeVector newGammaDirection(xDir,yDir,zDir);
   
-  G4int shellNum = 0;
-  G4int maxNumOfShells = transitionManager->NumberOfReachableShells(Z);
-  
-  // find the index of the shell named shellId
-  while (shellId != transitionManager->
-	 ReachableShell(Z,shellNum)->FinalShellId())
-    {
-      if(shellNum == maxNumOfShells-1)
-	{
-	  break;
-	}
-      shellNum++;
-    }
-  // number of shell from wich an electron can reach shellId
-  size_t transitionSize = transitionManager->
-    ReachableShell(Z,shellNum)->OriginatingShellIds().size();
-  
-  size_t index = 0;
-  
-  // find the index of the shell named provShellId in the vector
-  // storing the shells from which shellId can be reached 
-  while (provShellId != transitionManager->
-	 ReachableShell(Z,shellNum)->OriginatingShellId(index))
-    {
-      if(index ==  transitionSize-1)
-	{
-	  break;
-	}
-      index++;
-    }
-  // energy of the gamma leaving provShellId for shellId
-  G4double transitionEnergy = transitionManager->
-    ReachableShell(Z,shellNum)->TransitionEnergy(index);
+  // energy of the gamma leaving the originating shell
+  G4double transitionEnergy = table.LineEnergy(line);
   
   // This is the shell where the new vacancy is: it is the same
   // shell where the electron came from
-  newShellId = transitionManager->
-    ReachableShell(Z,shellNum)->OriginatingShellId(index);
-  
+  newShellId = table.OriginatingShellId(line);
   
   G4DynamicParticle* newPart = new G4DynamicParticle(G4Gamma::Gamma(), 
 						     newGammaDirection,
@@ -275,7 +167,8 @@ G4DynamicParticle* G4RDAtomicDeexcitation::GenerateFluorescence(G4int Z,
   return newPart;
 }
 
-G4DynamicParticle* G4RDAtomicDeexcitation::GenerateAuger(G4int Z, G4int shellId)
+G4DynamicParticle* G4RDAtomicDeexcitation::GenerateAuger(G4int Z, G4int shellId,
+                                                         G4int& newShellId) const
 {
   if(!fAuger) return 0;
   
@@ -494,18 +387,3 @@ G4DynamicParticle* G4RDAtomicDeexcitation::GenerateAuger(G4int Z, G4int shellId)
     }
   
 }
-
-void G4RDAtomicDeexcitation::SetCutForSecondaryPhotons(G4double cut)
-{
-  minGammaEnergy = cut;
-}
-
-void G4RDAtomicDeexcitation::SetCutForAugerElectrons(G4double cut)
-{
-  minElectronEnergy = cut;
-}
-
-void G4RDAtomicDeexcitation::ActivateAugerElectronProduction(G4bool val)
-{
-  fAuger = val;
-}
@@ -33,91 +33,33 @@
 // History:
 // -----------
 // 16 Sep 2001 E. Guardincerri  First Committed to cvs
+// 16 Oct 2026                  Thread-safe Instance(); tables loaded per
+//                              element on first use, Auger data on demand
+// 16 Oct 2026                  Flat per-element tables; accessors no longer
+//                              copy the tables
 //
 // -------------------------------------------------------------------
 
 #include "G4RDAtomicTransitionManager.hh"
+#include "G4AutoLock.hh"
 
 G4RDAtomicTransitionManager::G4RDAtomicTransitionManager(G4int minZ, G4int maxZ, 
   G4int limitInfTable,G4int limitSupTable)
-  :zMin(minZ), 
+  :elementTables(maxZ + 1),
+  shellManager(0),
+  augerData(0),
+  zMin(minZ), 
   zMax(maxZ),
   infTableLimit(limitInfTable),
   supTableLimit(limitSupTable)
 {
-  // infTableLimit is initialized to 6 because EADL lacks data for Z<=5
-  G4RDShellData* shellManager = new G4RDShellData;
-
-  // initialization of the data for auger effect
-  
-  augerData = new G4RDAugerData;
-
-  shellManager->LoadData("/fluor/binding");
-  
-  // Fills shellTable with the data from EADL, identities and binding 
-  // energies of shells
-  for (G4int Z = zMin; Z<= zMax; Z++)
+  // infTableLimit is initialized to 6 because EADL lacks data for Z<=5.
+  // Nothing is read here: a CASCADE run only needs the elements of the
+  // capture isotopes, which Element() loads when they are first used.
+  for (size_t Z = 0; Z < elementTables.size(); Z++)
     {
-      std::vector<G4RDAtomicShell*> vectorOfShells;  
-      size_t shellIndex = 0; 
-
-      size_t numberOfShells=shellManager->NumberOfShells(Z);
-      for (shellIndex = 0; shellIndex<numberOfShells; shellIndex++) 
-	{ 
-	  G4int shellId = shellManager->ShellId(Z,shellIndex);
-	  G4double bindingEnergy = shellManager->BindingEnergy(Z,shellIndex);
-	 
-	  G4RDAtomicShell * shell = new G4RDAtomicShell(shellId,bindingEnergy);
-	
-	  vectorOfShells.push_back(shell);
-	}
-    
-      //     shellTable.insert(std::make_pair(Z, vectorOfShells));
-      shellTable[Z] = vectorOfShells;
-    }
-  
-  // Fills transitionTable with the data from EADL, identities, transition 
-  // energies and transition probabilities
-  for (G4int Znum= infTableLimit; Znum<=supTableLimit; Znum++)
-    {  G4RDFluoData* fluoManager = new G4RDFluoData;
-    std::vector<G4RDFluoTransition*> vectorOfTransitions;
-    fluoManager->LoadData(Znum);
-    
-    size_t numberOfVacancies = fluoManager-> NumberOfVacancies();
-    
-    for (size_t vacancyIndex = 0; vacancyIndex<numberOfVacancies;  vacancyIndex++)
-      
-      {
-	std::vector<G4int>  vectorOfIds;
-	G4DataVector vectorOfEnergies;
-	G4DataVector vectorOfProbabilities;
-	
-	G4int finalShell = fluoManager->VacancyId(vacancyIndex);
-	size_t numberOfTransitions = fluoManager->NumberOfTransitions(vacancyIndex);
-	for (size_t origShellIndex = 0; origShellIndex < numberOfTransitions;
-	     origShellIndex++)
-	    
-	  {
-	    
-	    G4int originatingShellId = fluoManager->StartShellId(origShellIndex,vacancyIndex);
-	    
-	    vectorOfIds.push_back(originatingShellId);
-	    
-	    G4double transitionEnergy = fluoManager->StartShellEnergy(origShellIndex,vacancyIndex);
-	    vectorOfEnergies.push_back(transitionEnergy);
-	    G4double transitionProbability = fluoManager->StartShellProb(origShellIndex,vacancyIndex);
-	    vectorOfProbabilities.push_back(transitionProbability);
-	  }
-	  G4RDFluoTransition * transition = new G4RDFluoTransition (finalShell,vectorOfIds,
-								    vectorOfEnergies,vectorOfProbabilities);
-	  vectorOfTransitions.push_back(transition); 
-      }
-    //      transitionTable.insert(std::make_pair(Znum, vectorOfTransitions));
-    transitionTable[Znum] = vectorOfTransitions;
-      
-      delete fluoManager;
+      elementTables[Z].store(0, std::memory_order_relaxed);
     }
-  delete shellManager;
 }
 
 G4RDAtomicTransitionManager::~G4RDAtomicTransitionManager()
@@ -125,61 +67,109 @@ G4RDAtomicTransitionManager::~G4RDAtomicTransitionManager()
 { 
 
   delete augerData;
+  delete shellManager;
 
-std::map<G4int,std::vector<G4RDAtomicShell*>,std::less<G4int> >::iterator pos;
- 
- for (pos = shellTable.begin(); pos != shellTable.end(); pos++){
-   
-   std::vector< G4RDAtomicShell*>vec = (*pos).second;
-   
-   G4int vecSize=vec.size();
-   
-   for (G4int i=0; i< vecSize; i++){
-     G4RDAtomicShell* shell = vec[i];
-     delete shell;     
-   }
-   
- }
- 
- std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::iterator ppos;
- 
- for (ppos = transitionTable.begin(); ppos != transitionTable.end(); ppos++){
-   
-   std::vector<G4RDFluoTransition*>vec = (*ppos).second;
-   
-   G4int vecSize=vec.size();
-   
-   for (G4int i=0; i< vecSize; i++){
-	 G4RDFluoTransition* transition = vec[i];
-	 delete transition;      
-   }
-   
- }   
- 
-}
+  for (size_t Z = 0; Z < elementTables.size(); Z++)
+    {
+      const ElementTables* tables = elementTables[Z].load(std::memory_order_acquire);
+      if (!tables) continue;
 
-G4RDAtomicTransitionManager* G4RDAtomicTransitionManager::instance = 0;
+      for (size_t i = 0; i < tables->shells.size(); i++) delete tables->shells[i];
+      for (size_t i = 0; i < tables->transitions.size(); i++) delete tables->transitions[i];
+      delete tables->relaxation;
+      delete tables;
+    }
+}
 
 G4RDAtomicTransitionManager* G4RDAtomicTransitionManager::Instance()
 {
-  if (instance == 0)
+  // Initialization of a function-local static is thread-safe
+  static G4RDAtomicTransitionManager manager;
+  return &manager;
+}
+
+const G4RDAtomicTransitionManager::ElementTables*
+G4RDAtomicTransitionManager::Element(G4int Z) const
+{
+  if (Z < zMin || Z > zMax) return 0;
+
+  const ElementTables* tables = elementTables[Z].load(std::memory_order_acquire);
+  if (tables) return tables;
+
+  G4AutoLock lock(&elementMutex);
+  tables = elementTables[Z].load(std::memory_order_relaxed);
+  if (tables) return tables;
+
+  if (!shellManager)
     {
-      instance = new G4RDAtomicTransitionManager;
-     
+      shellManager = new G4RDShellData;
+      shellManager->LoadData("/fluor/binding");
     }
-  return instance;
+
+  ElementTables* newTables = new ElementTables;
+
+  // Identities and binding energies of the shells
+  size_t numberOfShells = shellManager->NumberOfShells(Z);
+  for (size_t shellIndex = 0; shellIndex<numberOfShells; shellIndex++) 
+    { 
+      G4int shellId = shellManager->ShellId(Z,shellIndex);
+      G4double bindingEnergy = shellManager->BindingEnergy(Z,shellIndex);
+      newTables->shells.push_back(new G4RDAtomicShell(shellId,bindingEnergy));
+    }
+
+  // Identities, transition energies and transition probabilities
+  newTables->hasTransitions = (Z >= infTableLimit && Z <= supTableLimit);
+  if (newTables->hasTransitions)
+    {
+      G4RDFluoData fluoManager;
+      fluoManager.LoadData(Z);
+
+      size_t numberOfVacancies = fluoManager.NumberOfVacancies();
+      for (size_t vacancyIndex = 0; vacancyIndex<numberOfVacancies;  vacancyIndex++)
+	{
+	  std::vector<G4int>  vectorOfIds;
+	  G4DataVector vectorOfEnergies;
+	  G4DataVector vectorOfProbabilities;
+	
+	  G4int finalShell = fluoManager.VacancyId(vacancyIndex);
+	  size_t numberOfTransitions = fluoManager.NumberOfTransitions(vacancyIndex);
+	  for (size_t origShellIndex = 0; origShellIndex < numberOfTransitions;
+	       origShellIndex++)
+	    {
+	      vectorOfIds.push_back(fluoManager.StartShellId(origShellIndex,vacancyIndex));
+	      vectorOfEnergies.push_back(fluoManager.StartShellEnergy(origShellIndex,vacancyIndex));
+	      vectorOfProbabilities.push_back(fluoManager.StartShellProb(origShellIndex,vacancyIndex));
+	    }
+	  newTables->transitions.push_back(new G4RDFluoTransition(finalShell,vectorOfIds,
+								  vectorOfEnergies,vectorOfProbabilities));
+	}
+    }
+
+  newTables->relaxation = new G4RDRelaxationTable(Z, newTables->shells, newTables->transitions);
+
+  elementTables[Z].store(newTables, std::memory_order_release);
+  return newTables;
 }
 
+const G4RDRelaxationTable* G4RDAtomicTransitionManager::RelaxationTable(G4int Z) const
+{
+  const ElementTables* tables = Element(Z);
+  return tables ? tables->relaxation : 0;
+}
+
+G4RDAugerData* G4RDAtomicTransitionManager::AugerData() const
+{
+  std::call_once(augerOnce, [this]() { augerData = new G4RDAugerData; });
+  return augerData;
+}
 
 G4RDAtomicShell* G4RDAtomicTransitionManager::Shell(G4int Z, size_t shellIndex) const
 { 
-  std::map<G4int,std::vector<G4RDAtomicShell*>,std::less<G4int> >::const_iterator pos;
-  
-  pos = shellTable.find(Z);
+  const ElementTables* tables = Element(Z);
   
-  if (pos!= shellTable.end())
+  if (tables)
     {
-      std::vector<G4RDAtomicShell*> v = (*pos).second;
+      const std::vector<G4RDAtomicShell*>& v = tables->shells;
       if (shellIndex<v.size())
 	{
 	  return(v[shellIndex]);
@@ -214,12 +204,10 @@ G4RDAtomicShell* G4RDAtomicTransitionManager::Shell(G4int Z, size_t shellIndex)
 
 const G4RDFluoTransition* G4RDAtomicTransitionManager::ReachableShell(G4int Z,size_t shellIndex) const
 {
-
-  std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::const_iterator pos;
-  pos = transitionTable.find(Z);
-  if (pos!= transitionTable.end())
+  const ElementTables* tables = Element(Z);
+  if (tables && tables->hasTransitions)
     {
-      std::vector<G4RDFluoTransition*> v = (*pos).second;      
+      const std::vector<G4RDFluoTransition*>& v = tables->transitions;
       if (shellIndex < v.size()) return(v[shellIndex]);
       else {
 	G4Exception("G4RDAtomicTransitionManager::ReachableShell()",
@@ -240,7 +228,7 @@ const G4RDFluoTransition* G4RDAtomicTransitionManager::ReachableShell(G4int Z,si
 const G4RDAugerTransition* G4RDAtomicTransitionManager::ReachableAugerShell(G4int Z, G4int vacancyShellIndex) const
 {
   
-  G4RDAugerTransition* augerTransition = augerData->GetAugerTransition(Z,vacancyShellIndex);
+  G4RDAugerTransition* augerTransition = AugerData()->GetAugerTransition(Z,vacancyShellIndex);
   return augerTransition;
 }
 
@@ -248,16 +236,11 @@ const G4RDAugerTransition* G4RDAtomicTransitionManager::ReachableAugerShell(G4in
 
 G4int G4RDAtomicTransitionManager::NumberOfShells (G4int Z) const
 {
+  const ElementTables* tables = Element(Z);
 
-std::map<G4int,std::vector<G4RDAtomicShell*>,std::less<G4int> >::const_iterator pos;
+  if (tables){
 
-  pos = shellTable.find(Z);
-
-  if (pos!= shellTable.end()){
-
-    std::vector<G4RDAtomicShell*> v = (*pos).second;
-
-    return v.size();
+    return tables->shells.size();
   }
 
   else{
@@ -274,14 +257,11 @@ std::map<G4int,std::vector<G4RDAtomicShell*>,std::less<G4int> >::const_iterator
 
 G4int G4RDAtomicTransitionManager::NumberOfReachableShells(G4int Z) const
 {
-std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::const_iterator pos;
-
-  pos = transitionTable.find(Z);
+  const ElementTables* tables = Element(Z);
 
-  if (pos!= transitionTable.end())
+  if (tables && tables->hasTransitions)
     {
-      std::vector<G4RDFluoTransition*> v = (*pos).second;
-      return v.size();
+      return tables->transitions.size();
     }
   else
     {
@@ -298,7 +278,7 @@ std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::const_iterat
 
 G4int G4RDAtomicTransitionManager::NumberOfReachableAugerShells(G4int Z)const 
 {
-  G4int n = augerData->NumberOfVacancies(Z);
+  G4int n = AugerData()->NumberOfVacancies(Z);
   return n;
 }
 
@@ -308,18 +288,16 @@ G4double G4RDAtomicTransitionManager::TotalRadiativeTransitionProbability(G4int
 									size_t shellIndex)
 
 {
-std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::iterator pos;
+  const ElementTables* tables = Element(Z);
 
-  pos = transitionTable.find(Z);
-
-  if (pos!= transitionTable.end())
+  if (tables && tables->hasTransitions)
     {
-      std::vector<G4RDFluoTransition*> v = (*pos).second;
+      const std::vector<G4RDFluoTransition*>& v = tables->transitions;
       
     if (shellIndex < v.size())
       {
 	G4RDFluoTransition* transition = v[shellIndex];
-	G4DataVector transProb = transition->TransitionProbabilities();
+	const G4DataVector& transProb = transition->TransitionProbabilities();
 	G4double totalRadTransProb = 0;
 	
 	for (size_t j = 0; j<transProb.size(); j++) // AM -- corrected, it was 1
@@ -349,20 +327,17 @@ std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::iterator pos
 G4double G4RDAtomicTransitionManager::TotalNonRadiativeTransitionProbability(G4int Z, size_t shellIndex)
 
 {
-
-  std::map<G4int,std::vector<G4RDFluoTransition*>,std::less<G4int> >::iterator pos;
-  
-  pos = transitionTable.find(Z);
+  const ElementTables* tables = Element(Z);
   
-  if (pos!= transitionTable.end()){
+  if (tables && tables->hasTransitions){
     
-    std::vector<G4RDFluoTransition*> v = (*pos).second;
+    const std::vector<G4RDFluoTransition*>& v = tables->transitions;
   
     
     if (shellIndex<v.size()){
 
       G4RDFluoTransition* transition=v[shellIndex];
-      G4DataVector transProb = transition->TransitionProbabilities();
+      const G4DataVector& transProb = transition->TransitionProbabilities();
       G4double totalRadTransProb = 0;
       
       for(size_t j = 0; j<transProb.size(); j++) // AM -- Corrected, was 1
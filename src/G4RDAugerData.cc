@@ -34,10 +34,13 @@
 // Based on G4RDFluoData by Elena Guardincerri
 // 
 // Modified: 30.07.02 VI Add select active Z + clean up against pedantic compiler
+// Modified: 16.10.26    Elements loaded on first request, thread-safe and quiet
 //
 // -------------------------------------------------------------------
 
 #include "G4RDAugerData.hh"
+#include "G4RDDataCache.hh"
+#include "G4AutoLock.hh"
 #include "G4DataVector.hh"
 #include "G4Material.hh"
 #include "G4Element.hh"
@@ -45,20 +48,16 @@
 #include <fstream>
 #include <sstream>
 
+extern bool g_quietMode;
+
 G4RDAugerData::G4RDAugerData()
+  : augerTransitionTable(maxZ + 1),
+    numberOfVacancies(maxZ + 1, 0),
+    loaded(new std::atomic<bool>[maxZ + 1])
 {
-
-  G4int n = 0;
-  G4int pos = 0;
-
-    for (pos = 0 ; pos < 100; pos++) 
-      {
-	numberOfVacancies.push_back(n);
-      }
-
-  BuildAugerTransitionTable(); 
-
-
+  // Nothing is read here: the transitions of an element are loaded by
+  // Transitions(Z) the first time one of the accessors asks for it
+  for (G4int Z = 0; Z <= maxZ; Z++) loaded[Z].store(false, std::memory_order_relaxed);
 }
 
 G4RDAugerData::~G4RDAugerData()
@@ -110,22 +109,43 @@ G4RDAugerData::~G4RDAugerData()
 
 size_t G4RDAugerData::NumberOfVacancies(G4int Z) const
 {
+  if (!Transitions(Z)) return 0;
   return numberOfVacancies[Z];
 }
 
+const std::vector<G4RDAugerTransition>* G4RDAugerData::Transitions(G4int Z) const
+{
+  if (Z < minZ || Z > maxZ) return 0;
+  if (loaded[Z].load(std::memory_order_acquire)) return &augerTransitionTable[Z];
+
+  // First request for Z: read it once, then publish it read-only
+  G4AutoLock lock(&loadMutex);
+  if (!loaded[Z].load(std::memory_order_relaxed))
+    {
+      G4RDAugerData* self = const_cast<G4RDAugerData*>(this);
+      self->augerTransitionTable[Z] = self->LoadData(Z);
+      if (!g_quietMode)
+	{
+	  G4cout << "G4RDAugerData for Element no. " << Z << " are loaded" << G4endl;
+	}
+      loaded[Z].store(true, std::memory_order_release);
+    }
+  return &augerTransitionTable[Z];
+}
+
 G4int G4RDAugerData::VacancyId(G4int Z, G4int vacancyIndex) const
 {
 
   G4int n = 0;
-  if (vacancyIndex<0 || vacancyIndex>=numberOfVacancies[Z])
+  if (vacancyIndex<0 || vacancyIndex>=(G4int)NumberOfVacancies(Z))
     {G4Exception("G4RDAugerData::VacancyId()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::VacancyId()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
     n = (G4int) dataSet[vacancyIndex].FinalShellId();
   }
   
@@ -140,15 +160,15 @@ G4int G4RDAugerData::VacancyId(G4int Z, G4int vacancyIndex) const
 size_t G4RDAugerData::NumberOfTransitions(G4int Z, G4int vacancyIndex) const
 {
   G4int n = 0;
-  if (vacancyIndex<0 || vacancyIndex>=numberOfVacancies[Z])
+  if (vacancyIndex<0 || vacancyIndex>=(G4int)NumberOfVacancies(Z))
     {G4Exception("G4RDAugerData::NumberOfTransitions()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::NumberOfTransitions()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
     n = (G4int)dataSet[vacancyIndex].TransitionOriginatingShellIds()->size();
   }
  return  n;
@@ -159,15 +179,15 @@ size_t G4RDAugerData::NumberOfTransitions(G4int Z, G4int vacancyIndex) const
 size_t G4RDAugerData::NumberOfAuger(G4int Z, G4int initIndex, G4int vacancyId) const
 {
   size_t n = 0;
-  if (initIndex<0 || initIndex>=numberOfVacancies[Z])
+  if (initIndex<0 || initIndex>=(G4int)NumberOfVacancies(Z))
     {G4Exception("G4RDAugerData::NumberOfAuger()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::NumberOfAuger()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
     const std::vector<G4int>* temp =  dataSet[initIndex].AugerOriginatingShellIds(vacancyId);
     n = temp->size();
   }
@@ -177,15 +197,15 @@ size_t G4RDAugerData::NumberOfAuger(G4int Z, G4int initIndex, G4int vacancyId) c
 size_t G4RDAugerData::AugerShellId(G4int Z, G4int vacancyIndex, G4int transId, G4int augerIndex) const
 {
   size_t n = 0;  
-  if (vacancyIndex<0 || vacancyIndex>=numberOfVacancies[Z])
+  if (vacancyIndex<0 || vacancyIndex>=(G4int)NumberOfVacancies(Z))
     {G4Exception("G4RDAugerData::AugerShellId()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::AugerShellId()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
     n = dataSet[vacancyIndex].AugerOriginatingShellId(augerIndex,transId);
   }
   return n;
@@ -195,15 +215,15 @@ G4int G4RDAugerData::StartShellId(G4int Z, G4int vacancyIndex, G4int transitionS
 {
   G4int n = 0; 
 
-  if (vacancyIndex<0 || vacancyIndex>=numberOfVacancies[Z]) 
+  if (vacancyIndex<0 || vacancyIndex>=(G4int)NumberOfVacancies(Z)) 
     {G4Exception("G4RDAugerData::StartShellId()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::StartShellId()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
      n = dataSet[vacancyIndex].TransitionOriginatingShellId(transitionShellIndex);
   }
    
@@ -215,15 +235,15 @@ G4double G4RDAugerData::StartShellEnergy(G4int Z, G4int vacancyIndex, G4int tran
 {
   G4double energy = 0;
   
-  if (vacancyIndex<0 || vacancyIndex>=numberOfVacancies[Z])
+  if (vacancyIndex<0 || vacancyIndex>=(G4int)NumberOfVacancies(Z))
     {G4Exception("G4RDAugerData::StartShellEnergy()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::StartShellEnergy()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
     energy = dataSet[vacancyIndex].AugerTransitionEnergy(augerIndex,transitionId);
       
   }
@@ -235,15 +255,15 @@ G4double G4RDAugerData::StartShellProb(G4int Z, G4int vacancyIndex,G4int transit
 {
   G4double prob = 0;
     
-  if (vacancyIndex<0 || vacancyIndex>=numberOfVacancies[Z]) 
+  if (vacancyIndex<0 || vacancyIndex>=(G4int)NumberOfVacancies(Z)) 
     {G4Exception("G4RDAugerData::StartShellProb()", "OutOfRange",
                  FatalException, "VacancyIndex outside boundaries!");}
   else {
-    trans_Table::const_iterator element = augerTransitionTable.find(Z);
-    if (element == augerTransitionTable.end())
+    const std::vector<G4RDAugerTransition>* element = Transitions(Z);
+    if (!element)
       {G4Exception("G4RDAugerData::StartShellProb()", "NoDataFound",
                    FatalException, "Data not loaded!");}
-    std::vector<G4RDAugerTransition> dataSet = (*element).second;
+    const std::vector<G4RDAugerTransition>& dataSet = *element;
     prob = dataSet[vacancyIndex].AugerTransitionProbability(augerIndex, transitionId);
 
 
@@ -275,10 +295,9 @@ std::vector<G4RDAugerTransition> G4RDAugerData::LoadData(G4int Z)
   
     G4String pathString(path);
     G4String dirFile = pathString + "/auger/" + name;
-    std::ifstream file(dirFile);
-    std::filebuf* lsdp = file.rdbuf();
+    G4RDTokenStream file(pathString, "auger/" + name);
   
-    if (! (lsdp->is_open()) )
+    if (! (file.is_open()) )
       {
 	G4String excep = "Data file: " + dirFile + " not found!";
 	G4Exception("G4RDAugerData::LoadData()", "DataNotFound",
@@ -502,17 +521,15 @@ void G4RDAugerData::BuildAugerTransitionTable()
   }
 
 
-  for (G4int element = 6; element < 101; element++)
+  for (G4int element = minZ; element <= maxZ; element++)
     { 
       if(nMaterials == 0 || activeZ.contains(element)) {
-        augerTransitionTable.insert(trans_Table::value_type(element,LoadData(element)));
-      
-        G4cout << "G4RDAugerData for Element no. " << element << " are loaded" << G4endl;
+        Transitions(element);
       //      PrintData(element);
       }    
     }
   
-  G4cout << "AugerTransitionTable complete"<< G4endl;
+  if (!g_quietMode) G4cout << "AugerTransitionTable complete"<< G4endl;
 }
 
 void G4RDAugerData::PrintData(G4int Z) 
@@ -548,7 +565,9 @@ void G4RDAugerData::PrintData(G4int Z)
 }
 G4RDAugerTransition* G4RDAugerData::GetAugerTransition(G4int Z,G4int vacancyShellIndex)
     {
-      std::vector<G4RDAugerTransition>* dataSet = &augerTransitionTable[Z];
+      std::vector<G4RDAugerTransition>* dataSet = 
+        const_cast<std::vector<G4RDAugerTransition>*>(Transitions(Z));
+      if (!dataSet) return 0;
       std::vector<G4RDAugerTransition>::iterator vectorIndex = dataSet->begin() + vacancyShellIndex;
 
       G4RDAugerTransition* augerTransition = &(*vectorIndex);
@@ -557,7 +576,6 @@ G4RDAugerTransition* G4RDAugerData::GetAugerTransition(G4int Z,G4int vacancyShel
   
 std::vector<G4RDAugerTransition>* G4RDAugerData::GetAugerTransitions(G4int Z)
   {
-    std::vector<G4RDAugerTransition>* dataSet = &augerTransitionTable[Z];
-    return dataSet;
+    return const_cast<std::vector<G4RDAugerTransition>*>(Transitions(Z));
   }
  
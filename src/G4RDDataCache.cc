@@ -0,0 +1,334 @@
+// ==============================================================================
+// G4RDDataCache.cc - Memory-mapped binary cache of the EADL relaxation data
+// ==============================================================================
+
+#include "G4RDDataCache.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern bool g_quietMode;
+
+namespace {
+
+const char kMagic[8] = { 'G', '4', 'R', 'D', 'E', 'A', 'D', 'L' };
+const uint32_t kVersion = 1;
+const size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t) + sizeof(uint64_t)
+                         + 2 * sizeof(uint32_t);
+
+// Elements with fluorescence and Auger data in EADL
+const G4int kMinZ = 6;
+const G4int kMaxZ = 100;
+
+size_t Align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+// 64-bit FNV-1a
+uint64_t Checksum(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Size and modification time of a source file; false if it does not exist
+G4bool SourceStamp(const G4String& path, uint64_t& size, int64_t& mtime)
+{
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) return false;
+  size = st.st_size;
+  mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+  return true;
+}
+
+G4String DataDirectory()
+{
+  const char* path = std::getenv("G4LEDATA");
+  return path ? G4String(path) : G4String();
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4RDDataCache* G4RDDataCache::Instance()
+{
+  static const G4RDDataCache instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RDDataCache::G4RDDataCache()
+: fData(nullptr),
+  fSize(0),
+  fNFiles(0),
+  fIndex(nullptr)
+{
+  G4String dataDir = DataDirectory();
+  if (!dataDir.empty()) Open(DefaultPath(), dataDir);
+}
+
+G4RDDataCache::~G4RDDataCache()
+{
+  if (fData) munmap(const_cast<char*>(fData), fSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String G4RDDataCache::DefaultPath()
+{
+  const char* path = std::getenv("G4RD_DATA_CACHE");
+  if (path && *path) return path;
+  const char* home = std::getenv("HOME");
+  return G4String(home ? home : ".") + "/.cache/HPGeDual/G4LEDATA.cache";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4RDDataCache::Open(const G4String& path, const G4String& dataDir)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;   // no cache: read the text files
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < kHeaderSize) {
+    close(fd);
+    G4cerr << "WARNING: " << path << " is not a valid G4LEDATA cache, ignoring it" << G4endl;
+    return false;
+  }
+
+  size_t size = st.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    G4cerr << "WARNING: Could not map " << path << ", ignoring it" << G4endl;
+    return false;
+  }
+
+  const char* bytes = static_cast<const char*>(data);
+  uint32_t version, nFiles, pathLength;
+  uint64_t indexChecksum;
+  size_t pos = sizeof(kMagic);
+  std::memcpy(&version, bytes + pos, sizeof(uint32_t));       pos += sizeof(uint32_t);
+  std::memcpy(&nFiles, bytes + pos, sizeof(uint32_t));        pos += sizeof(uint32_t);
+  std::memcpy(&indexChecksum, bytes + pos, sizeof(uint64_t)); pos += sizeof(uint64_t);
+  std::memcpy(&pathLength, bytes + pos, sizeof(uint32_t));
+
+  // Header, path and index must lie in the file and match their checksum
+  size_t indexOffset = Align8(kHeaderSize + pathLength);
+  G4bool valid = std::memcmp(bytes, kMagic, sizeof(kMagic)) == 0 && version == kVersion
+              && indexOffset + (size_t)nFiles * sizeof(IndexEntry) <= size;
+  if (valid) {
+    uint64_t checksum = Checksum(bytes + kHeaderSize, pathLength);
+    checksum = Checksum(bytes + indexOffset, nFiles * sizeof(IndexEntry), checksum);
+    valid = checksum == indexChecksum;
+  }
+  const IndexEntry* index = reinterpret_cast<const IndexEntry*>(bytes + indexOffset);
+  for (uint32_t i = 0; valid && i < nFiles; i++) {
+    valid = index[i].offset % 8 == 0 && index[i].offset <= size
+         && index[i].count <= (size - index[i].offset) / sizeof(G4double)
+         && index[i].name[sizeof(index[i].name) - 1] == '\0';
+  }
+  if (!valid) {
+    munmap(data, size);
+    G4cerr << "WARNING: " << path << " is not a valid G4LEDATA cache (version "
+           << kVersion << " expected), ignoring it" << G4endl;
+    return false;
+  }
+
+  // Built from this G4LEDATA, and no source file changed since
+  G4String stale;
+  if (std::string(bytes + kHeaderSize, pathLength) != dataDir) {
+    stale = "it was built from another G4LEDATA directory";
+  }
+  for (uint32_t i = 0; stale.empty() && i < nFiles; i++) {
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!SourceStamp(dataDir + "/" + index[i].name, sourceSize, sourceTime)
+        || sourceSize != index[i].size || sourceTime != index[i].mtime) {
+      stale = G4String(index[i].name) + " changed since it was built";
+    }
+  }
+  if (!stale.empty()) {
+    munmap(data, size);
+    if (!g_quietMode) {
+      G4cout << "G4LEDATA cache " << path << " is out of date (" << stale
+             << "), reading the text files; rebuild it with -build-eadl-cache" << G4endl;
+    }
+    return false;
+  }
+
+  fData = bytes;
+  fSize = size;
+  fNFiles = nFiles;
+  fIndex = index;
+  fChecked.reset(new std::atomic<char>[nFiles]);
+  for (uint32_t i = 0; i < nFiles; i++) fChecked[i].store(0, std::memory_order_relaxed);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4RDDataCache::Find(const G4String& name, const G4double*& values, size_t& count) const
+{
+  for (uint32_t i = 0; i < fNFiles; i++) {
+    if (name != fIndex[i].name) continue;
+
+    const G4double* data = reinterpret_cast<const G4double*>(fData + fIndex[i].offset);
+    char checked = fChecked[i].load(std::memory_order_acquire);
+    if (checked == 0) {
+      // Concurrent first readers may both check; they store the same result
+      checked = (Checksum(data, fIndex[i].count * sizeof(G4double)) == fIndex[i].checksum) ? 1 : 2;
+      fChecked[i].store(checked, std::memory_order_release);
+      if (checked == 2) {
+        G4cerr << "WARNING: Corrupt entry " << name << " in the G4LEDATA cache, "
+               << "reading the text file" << G4endl;
+      }
+    }
+    if (checked != 1) return false;
+
+    values = data;
+    count = fIndex[i].count;
+    return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int G4RDDataCache::Build(const G4String& dataDir, const G4String& outputPath)
+{
+  if (dataDir.empty()) {
+    G4cerr << "ERROR: G4LEDATA environment variable not set" << G4endl;
+    return -1;
+  }
+
+  // The files the relaxation loaders read
+  std::vector<G4String> names;
+  names.push_back("fluor/binding.dat");
+  for (G4int Z = kMinZ; Z <= kMaxZ; Z++) {
+    names.push_back("fluor/fl-tr-pr-" + std::to_string(Z) + ".dat");
+  }
+  for (G4int Z = kMinZ; Z <= kMaxZ; Z++) {
+    names.push_back("auger/au-tr-pr-" + std::to_string(Z) + ".dat");
+  }
+
+  // Parse every file exactly as the loaders do, with operator>>
+  std::vector<IndexEntry> index;
+  std::vector<std::vector<G4double>> values;
+  uint32_t pathLength = dataDir.size();
+  size_t offset = 0;
+  for (size_t i = 0; i < names.size(); i++) {
+    G4String path = dataDir + "/" + names[i];
+    IndexEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    if (!SourceStamp(path, entry.size, entry.mtime)) continue;
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+      G4cerr << "WARNING: Could not read " << path << ", skipping it" << G4endl;
+      continue;
+    }
+    std::vector<G4double> numbers;
+    G4double a;
+    while (file >> a) numbers.push_back(a);
+
+    std::strncpy(entry.name, names[i].c_str(), sizeof(entry.name) - 1);
+    entry.offset = offset;   // relative to the values section for now
+    entry.count = numbers.size();
+    entry.checksum = Checksum(numbers.data(), numbers.size() * sizeof(G4double));
+    offset += numbers.size() * sizeof(G4double);
+    index.push_back(entry);
+    values.push_back(numbers);
+  }
+  if (index.empty()) {
+    G4cerr << "ERROR: No relaxation data files found in '" << dataDir << "'" << G4endl;
+    return -1;
+  }
+
+  size_t indexOffset = Align8(kHeaderSize + pathLength);
+  size_t valuesOffset = Align8(indexOffset + index.size() * sizeof(IndexEntry));
+  for (size_t i = 0; i < index.size(); i++) index[i].offset += valuesOffset;
+
+  uint32_t nFiles = index.size();
+  uint32_t reserved = 0;
+  uint64_t indexChecksum = Checksum(dataDir.data(), pathLength);
+  indexChecksum = Checksum(index.data(), index.size() * sizeof(IndexEntry), indexChecksum);
+
+  // Default location: create $HOME/.cache/HPGeDual if needed
+  size_t slash = outputPath.find_last_of('/');
+  if (slash != std::string::npos && slash > 0) {
+    G4String dir = outputPath.substr(0, slash);
+    for (size_t p = dir.find('/', 1); ; p = dir.find('/', p + 1)) {
+      mkdir(dir.substr(0, p).c_str(), 0755);
+      if (p == std::string::npos) break;
+    }
+  }
+
+  // Write to a temporary file and move it into place, so that a running job
+  // never maps a half-written cache
+  G4String tmpPath = outputPath + ".tmp";
+  std::ofstream out(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    G4cerr << "ERROR: Cannot write '" << tmpPath << "' (" << std::strerror(errno) << ")" << G4endl;
+    return -1;
+  }
+
+  const char padding[8] = { 0 };
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+  out.write(reinterpret_cast<const char*>(&nFiles), sizeof(nFiles));
+  out.write(reinterpret_cast<const char*>(&indexChecksum), sizeof(indexChecksum));
+  out.write(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+  out.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+  out.write(dataDir.data(), pathLength);
+  out.write(padding, indexOffset - kHeaderSize - pathLength);
+  out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+  out.write(padding, valuesOffset - indexOffset - index.size() * sizeof(IndexEntry));
+  for (size_t i = 0; i < values.size(); i++) {
+    out.write(reinterpret_cast<const char*>(values[i].data()), values[i].size() * sizeof(G4double));
+  }
+  size_t written = valuesOffset + offset;
+  out.close();
+
+  if (!out || std::rename(tmpPath.c_str(), outputPath.c_str()) != 0) {
+    G4cerr << "ERROR: Failed to write G4LEDATA cache '" << outputPath << "'" << G4endl;
+    std::remove(tmpPath.c_str());
+    return -1;
+  }
+
+  if (!g_quietMode) {
+    G4cout << "G4LEDATA cache written: " << outputPath << " (" << nFiles
+           << " files, " << written << " bytes)" << G4endl;
+  }
+  return (G4int)nFiles;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RDTokenStream::G4RDTokenStream(const G4String& dataDir, const G4String& name)
+: fValues(nullptr),
+  fCount(0),
+  fNext(0)
+{
+  const G4double* values;
+  size_t count;
+  if (G4RDDataCache::Instance()->Find(name, values, count)) {
+    fValues = values;
+    fCount = count;
+  } else {
+    fFile.open(dataDir + "/" + name);
+  }
+}
@@ -34,6 +34,7 @@
 // -------------------------------------------------------------------
 
 #include "G4RDFluoData.hh"
+#include "G4RDDataCache.hh"
 #include "G4DataVector.hh"
 #include "G4RDFluoTransition.hh"
 #include <fstream>
@@ -83,7 +84,7 @@ G4int G4RDFluoData::VacancyId(G4int vacancyIndex) const
       std::map<G4int,G4DataVector*,std::less<G4int> >::const_iterator pos;
       pos = idMap.find(vacancyIndex);
       if (pos!= idMap.end())
-	{ G4DataVector dataSet = (*(*pos).second);
+	{ const G4DataVector& dataSet = (*(*pos).second);
 	n = (G4int) dataSet[0];
 	
 	}
@@ -119,7 +120,7 @@ G4int G4RDFluoData::StartShellId(G4int initIndex, G4int vacancyIndex) const
     
      pos = idMap.find(vacancyIndex);
      
-     G4DataVector dataSet = *((*pos).second);
+     const G4DataVector& dataSet = *((*pos).second);
    
      G4int nData = dataSet.size();
      //The first Element of idMap's dataSets is the original shell of the vacancy, 
@@ -146,7 +147,7 @@ G4double G4RDFluoData::StartShellEnergy(G4int initIndex, G4int vacancyIndex) con
      
      pos = energyMap.find(vacancyIndex);
      
-     G4DataVector dataSet = *((*pos).second);
+     const G4DataVector& dataSet = *((*pos).second);
      
      G4int nData = dataSet.size();
      if (initIndex >= 0 && initIndex < nData)
@@ -171,7 +172,7 @@ G4double G4RDFluoData::StartShellProb(G4int initIndex, G4int vacancyIndex) const
      
      pos = probabilityMap.find(vacancyIndex);
      
-     G4DataVector dataSet = *((*pos).second);
+     const G4DataVector& dataSet = *((*pos).second);
      
      G4int nData = dataSet.size();
      if (initIndex >= 0 && initIndex < nData)
@@ -207,10 +208,9 @@ void G4RDFluoData::LoadData(G4int Z)
   G4String pathString(path);
   G4String fluor("/fluor/");
   G4String dirFile = pathString + fluor + name;
-  std::ifstream file(dirFile);
-  std::filebuf* lsdp = file.rdbuf();
+  G4RDTokenStream file(pathString, "fluor/" + name);
   
-  if (! (lsdp->is_open()) )
+  if (! (file.is_open()) )
     {
       G4String excep = "Data file: " + dirFile + " not found";
       G4Exception("G4RDEMDataSet::LoadData()", "DataNotFound",
@@ -0,0 +1,136 @@
+// ==============================================================================
+// G4RDRelaxationChains.cc - Complete radiative relaxation outcomes of a vacancy
+// ==============================================================================
+
+#include "G4RDRelaxationChains.hh"
+#include "G4RDAtomicTransitionManager.hh"
+#include "G4AutoLock.hh"
+#include <algorithm>
+#include <map>
+#include <memory>
+
+namespace {
+
+// Limits on the listing; beyond them the stepwise sampler is used
+const size_t kMaxOutcomes = 65536;
+const size_t kMaxPhotons = 64;
+
+G4Mutex chainsMutex = G4MUTEX_INITIALIZER;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4RDRelaxationChains* G4RDRelaxationChains::Get(G4int Z, G4int shellId)
+{
+  // Key is 1000*Z + shellId; a null entry records an element without data
+  static std::map<G4int, std::unique_ptr<const G4RDRelaxationChains>> chains;
+
+  G4AutoLock lock(&chainsMutex);
+  std::unique_ptr<const G4RDRelaxationChains>& entry = chains[1000*Z + shellId];
+  if (!entry) {
+    const G4RDRelaxationTable* table =
+      G4RDAtomicTransitionManager::Instance()->RelaxationTable(Z);
+    if (table) entry.reset(new G4RDRelaxationChains(*table, shellId));
+  }
+  return entry.get();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RDRelaxationChains::G4RDRelaxationChains(const G4RDRelaxationTable& table, G4int shellId)
+: fZ(table.GetZ()),
+  fShellId(shellId),
+  fComplete(true)
+{
+  fFirstPhoton.push_back(0);
+  std::vector<G4double> photons;
+  Enumerate(table, shellId, 1., photons);
+
+  if (!fComplete || fProbability.empty()) {
+    fComplete = false;
+    fProbability.clear();
+    fFirstPhoton.assign(1, 0);
+    fPhotonEnergy.clear();
+    return;
+  }
+  BuildAliasTable();
+}
+
+G4RDRelaxationChains::~G4RDRelaxationChains()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Follows every branch of the stepwise sampler: a line is taken when the
+// uniform draw is at most its cumulative probability, and the chain ends
+// when the draw exceeds all of them or the vacancy has no radiative lines
+void G4RDRelaxationChains::Enumerate(const G4RDRelaxationTable& table, G4int shellId,
+                                     G4double probability, std::vector<G4double>& photons)
+{
+  if (!fComplete) return;
+
+  G4int vacancy = table.Vacancy(shellId);
+  G4double end = 1.;
+  if (vacancy >= 0 && photons.size() < kMaxPhotons) {
+    G4double previous = 0.;
+    for (G4int line = table.FirstLine(vacancy); line < table.FirstLine(vacancy+1); line++) {
+      G4double cumulative = std::min(table.CumulativeProbability(line), 1.);
+      G4double p = cumulative - previous;
+      previous = std::max(previous, cumulative);
+      if (p <= 0.) continue;
+
+      photons.push_back(table.LineEnergy(line));
+      Enumerate(table, table.OriginatingShellId(line), probability * p, photons);
+      photons.pop_back();
+    }
+    end = 1. - previous;
+  } else if (vacancy >= 0) {
+    // A chain this long means the data loop; do not trust the listing
+    fComplete = false;
+    return;
+  }
+
+  if (end <= 0.) return;
+  if (fProbability.size() >= kMaxOutcomes) {
+    fComplete = false;
+    return;
+  }
+  fProbability.push_back(probability * end);
+  fPhotonEnergy.insert(fPhotonEnergy.end(), photons.begin(), photons.end());
+  fFirstPhoton.push_back((G4int)fPhotonEnergy.size());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Walker alias table (Vose's method) over the outcomes
+void G4RDRelaxationChains::BuildAliasTable()
+{
+  G4int n = NumberOfOutcomes();
+  G4double sum = 0.;
+  for (G4int i = 0; i < n; i++) sum += fProbability[i];
+
+  fCut.assign(n, 1.);
+  fAlias.resize(n);
+  std::vector<G4double> scaled(n);
+  std::vector<G4int> small, large;
+  for (G4int i = 0; i < n; i++) {
+    fAlias[i] = i;
+    scaled[i] = fProbability[i] * n / sum;
+    (scaled[i] < 1. ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    G4int s = small.back(); small.pop_back();
+    G4int l = large.back();
+    fCut[s] = scaled[s];
+    fAlias[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if (scaled[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // Left-overs are 1 up to rounding
+  for (G4int i : small) fCut[i] = 1.;
+  for (G4int i : large) fCut[i] = 1.;
+}
@@ -0,0 +1,51 @@
+// ==============================================================================
+// G4RDRelaxationTable.cc - Flat radiative relaxation table of one element
+// ==============================================================================
+
+#include "G4RDRelaxationTable.hh"
+#include "G4RDAtomicShell.hh"
+#include "G4RDFluoTransition.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RDRelaxationTable::G4RDRelaxationTable(G4int Z,
+                                         const std::vector<G4RDAtomicShell*>& shells,
+                                         const std::vector<G4RDFluoTransition*>& transitions)
+: fZ(Z)
+{
+  for (size_t i = 0; i < shells.size(); i++) {
+    fShellId.push_back(shells[i]->ShellId());
+    fBindingEnergy.push_back(shells[i]->BindingEnergy());
+  }
+
+  // Lines of every vacancy, with the probabilities summed in the order
+  // G4RDAtomicDeexcitation has always summed them
+  fFirstLine.push_back(0);
+  for (size_t v = 0; v < transitions.size(); v++) {
+    const G4RDFluoTransition* transition = transitions[v];
+    const G4DataVector& probabilities = transition->TransitionProbabilities();
+    G4double sum = 0.;
+    for (size_t i = 0; i < probabilities.size(); i++) {
+      sum += probabilities[i];
+      Line line = { sum, transition->TransitionEnergy(i), transition->OriginatingShellId(i) };
+      fLines.push_back(line);
+    }
+    fFirstLine.push_back((G4int)fLines.size());
+  }
+
+  // Shell id -> vacancy; ids beyond the id of the last radiative vacancy
+  // relax non-radiatively
+  if (transitions.empty()) return;
+  G4int lastVacancy = (G4int)transitions.size() - 1;
+  G4int lastId = transitions.back()->FinalShellId();
+  fVacancyOfShellId.assign(lastId + 1, lastVacancy);
+  for (G4int v = lastVacancy; v >= 0; v--) {
+    G4int id = transitions[v]->FinalShellId();
+    if (id > 0 && id <= lastId) fVacancyOfShellId[id] = v;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RDRelaxationTable::~G4RDRelaxationTable()
+{}
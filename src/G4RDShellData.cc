@@ -36,6 +36,7 @@
 // -------------------------------------------------------------------
 
 #include "G4RDShellData.hh"
+#include "G4RDDataCache.hh"
 #include "G4DataVector.hh"
 #include "G4SystemOfUnits.hh"
 #include <fstream>
@@ -131,7 +132,7 @@ G4int G4RDShellData::ShellId(G4int Z, G4int shellIndex) const
       pos = idMap.find(Z);
       if (pos!= idMap.end())
 	{
-	  std::vector<G4double> dataSet = *((*pos).second);
+	  const std::vector<G4double>& dataSet = *((*pos).second);
 	  G4int nData = dataSet.size();
 	  if (shellIndex >= 0 && shellIndex < nData)
 	    {
@@ -153,7 +154,7 @@ G4double G4RDShellData::ShellOccupancyProbability(G4int Z, G4int shellIndex) con
       pos = idMap.find(Z);
       if (pos!= idMap.end())
 	{
-	  std::vector<G4double> dataSet = *((*pos).second);
+	  const std::vector<G4double>& dataSet = *((*pos).second);
 	  G4int nData = dataSet.size();
 	  if (shellIndex >= 0 && shellIndex < nData)
 	    {
@@ -176,7 +177,7 @@ G4double G4RDShellData::BindingEnergy(G4int Z, G4int shellIndex)  const
       pos = bindingMap.find(Z);
       if (pos!= bindingMap.end())
 	{
-	  G4DataVector dataSet = *((*pos).second);
+	  const G4DataVector& dataSet = *((*pos).second);
 	  G4int nData = dataSet.size();
 	  if (shellIndex >= 0 && shellIndex < nData)
 	    {
@@ -254,10 +255,9 @@ void G4RDShellData::LoadData(const G4String& fileName)
   
   G4String pathString(path);
   G4String dirFile = pathString + name;
-  std::ifstream file(dirFile);
-  std::filebuf* lsdp = file.rdbuf();
+  G4RDTokenStream file(pathString, name.substr(name.find_first_not_of('/')));
 
-  if (! (lsdp->is_open()) )
+  if (! (file.is_open()) )
     {
       G4String s1("Data file: ");
       G4String s2(" not found");
@@ -3,6 +3,13 @@
 // ==============================================================================
 
 #include "PrimaryGeneratorAction.hh"
+#include "CascadeFilter.hh"
+#include "EmissionBiasing.hh"
+#include "RAINIERCascadeStore.hh"
+#include "RAINIERCursor.hh"
+#include "RAINIERFileList.hh"
+#include "RAINIERSampler.hh"
+#include "RAINIERStreamReader.hh"
 
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
@@ -16,6 +23,9 @@
 #include "Randomize.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4Gamma.hh"
 #include "G4ReactionProduct.hh"
 #include <fstream>
@@ -33,8 +43,7 @@
 #endif
 
 // ROOT headers for RAINIER file reading
-#include "TFile.h"
-#include "TTree.h"
+#include "TChain.h"
 
 // External global variable for quiet mode
 extern bool g_quietMode;
@@ -43,7 +52,8 @@ extern bool g_quietMode;
 
 PrimaryGeneratorAction::PrimaryGeneratorAction(const std::string& rainierFile,
                                                bool generateCascades,
-                                               SourceMode initialMode)
+                                               SourceMode initialMode,
+                                               const RAINIERCascadeStore* rainierStore)
 : G4VUserPrimaryGeneratorAction(),
   fParticleGun(0),
   fRAINIERFile(rainierFile),
@@ -55,14 +65,24 @@ PrimaryGeneratorAction::PrimaryGeneratorAction(const std::string& rainierFile,
   fExcitationEnergy(8.579),   // Cl-36 neutron separation energy (MeV)
   fCascadePosition(0, 0, 0),  // Default cascade position at origin
   fCascadeGenerator(nullptr),
-  fRAINIERRootFile(nullptr),
-  fRAINIERTree(nullptr),
-  fRAINIEREgs(nullptr),
-  fRAINIERExfs(nullptr),
+  fRAINIERHomeRange(0),
   fRAINIERCurrentEntry(0),
+  fRAINIERChunkEnd(0),
+  fRAINIERChunkFirst(0),
+  fRAINIERChunkRange(-1),
+  fRAINIERChunkPass(0),
+  fRAINIERChunkAccepted(false),
+  fRAINIERExhausted(false),
   fRAINIERTotalEntries(0),
   fRAINIEREmptyCount(0),
-  fTwoGammaOnly(false)
+  fRAINIERStore(rainierStore),
+  fRAINIERSampler(nullptr),
+  fRAINIERCascade(nullptr),
+  fRAINIERCascadeSize(0),
+  fRAINIERStream(nullptr),
+  fCascadeNucleusZ(0),
+  fCascadeNucleusA(0),
+  fCascadeNucleusEx(-1.)
 {
     G4int n_particle = 1;
     fParticleGun = new G4ParticleGun(n_particle);
@@ -77,6 +97,9 @@ PrimaryGeneratorAction::PrimaryGeneratorAction(const std::string& rainierFile,
 
     // Initialize CASCADE generator
     fCascadeGenerator = new G4CASCADE();
+    if (CascadeFilter::Instance()->IsActive()) {
+        fCascadeGenerator->SetFilter(CascadeFilter::Instance());
+    }
 
     // Debug output to verify constructor parameters
     if (!g_quietMode) {
@@ -117,8 +140,16 @@ PrimaryGeneratorAction::PrimaryGeneratorAction(const std::string& rainierFile,
         }
     }
 
-    // Initialize RAINIER ROOT file if specified
-    if (!fRAINIERFile.empty()) {
+    // Initialize RAINIER ROOT file if specified, unless the cascades were
+    // preloaded in main() or are streamed by the reader thread it started
+    if (RAINIERStreamReader::Instance()->IsActive()) {
+        fRAINIERStream = RAINIERStreamReader::Instance();
+    } else if (fRAINIERStore) {
+        RAINIERCursor::Instance()->Attach(fRAINIERStore->GetNumberOfCascades());
+        if (!fRAINIERStore->IsWeighted() && RAINIERSampler::GetMode() != RAINIERSampler::kSequential) {
+            fRAINIERSampler = new RAINIERSampler(*fRAINIERStore, G4Threading::G4GetThreadId());
+        }
+    } else if (!fRAINIERFile.empty()) {
         InitializeRAINIERFile();
     }
 }
@@ -129,15 +160,18 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
     delete fParticleGun;
     delete fCascadeGenerator;
+    delete fRAINIERSampler;
 
-    // Clean up RAINIER ROOT file resources
-    if (fRAINIERRootFile) {
-        if (!g_quietMode && fRAINIEREmptyCount > 0) {
-            G4cout << "RAINIER file statistics: Skipped " << fRAINIEREmptyCount
-                   << " empty cascades" << G4endl;
-        }
-        fRAINIERRootFile->Close();
-        delete fRAINIERRootFile;
+    // Clean up RAINIER ROOT file resources (the chains close their files)
+    if (!g_quietMode && fRAINIEREmptyCount > 0) {
+        G4cout << "RAINIER file statistics: Skipped " << fRAINIEREmptyCount
+               << " empty cascades" << G4endl;
+    }
+    for (RAINIERChain* chain : fRAINIERChains) {
+        if (!chain) continue;
+        chain->tree->ResetBranchAddresses();
+        delete chain->tree;
+        delete chain;
     }
 }
 
@@ -146,7 +180,7 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 void PrimaryGeneratorAction::SetSourceMode(SourceMode mode)
 {
     if (fSourceMode == mode) {
-        if (mode == CASCADE_RAINIER && !fRAINIERFile.empty() && fRAINIERRootFile == nullptr) {
+        if (mode == CASCADE_RAINIER && !fRAINIERFile.empty() && !fRAINIERStore && !fRAINIERStream && fRAINIERChains.empty()) {
             InitializeRAINIERFile();
         }
         return;
@@ -159,7 +193,7 @@ void PrimaryGeneratorAction::SetSourceMode(SourceMode mode)
                << SourceModeToString(mode) << G4endl;
     }
 
-    if (mode == CASCADE_RAINIER && !fRAINIERFile.empty() && fRAINIERRootFile == nullptr) {
+    if (mode == CASCADE_RAINIER && !fRAINIERFile.empty() && !fRAINIERStore && !fRAINIERStream && fRAINIERChains.empty()) {
         InitializeRAINIERFile();
     }
 }
@@ -212,12 +246,15 @@ void PrimaryGeneratorAction::GenerateSingleGammaEvent(G4Event* anEvent)
     G4ThreeVector sourcePos = SampleSourcePosition();
     fParticleGun->SetParticlePosition(sourcePos);
     
-    G4ThreeVector direction = SampleDirection();
+    G4int conesHeld = 0;
+    G4bool inCone = EmissionBiasing::Instance()->ChooseBiasedPrimary(1) == 0;
+    G4ThreeVector direction = SampleDirection(inCone, conesHeld);
     fParticleGun->SetParticleMomentumDirection(direction);
     
     fParticleGun->SetParticleTime(0.0);
     
     fParticleGun->GeneratePrimaryVertex(anEvent);
+    SetEventWeight(anEvent, conesHeld, 1);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -226,88 +263,80 @@ void PrimaryGeneratorAction::GenerateCo60Cascade(G4Event* anEvent)
 {
     // Generate Co-60 cascade (2 gammas per event)
     G4ThreeVector sourcePos = SampleSourcePosition();
+    G4int conesHeld = 0;
+    G4int biased = EmissionBiasing::Instance()->ChooseBiasedPrimary(2);
 
     // First gamma: 1.173 MeV
     fParticleGun->SetParticleEnergy(1.173 * MeV);
     fParticleGun->SetParticlePosition(sourcePos);
-    fParticleGun->SetParticleMomentumDirection(SampleDirection());
+    fParticleGun->SetParticleMomentumDirection(SampleDirection(biased == 0, conesHeld));
     fParticleGun->SetParticleTime(0.0);
     fParticleGun->GeneratePrimaryVertex(anEvent);
 
     // Second gamma: 1.332 MeV
     fParticleGun->SetParticleEnergy(1.332 * MeV);
     fParticleGun->SetParticlePosition(sourcePos);
-    fParticleGun->SetParticleMomentumDirection(SampleDirection());
+    fParticleGun->SetParticleMomentumDirection(SampleDirection(biased == 1, conesHeld));
     fParticleGun->SetParticleTime(0.0);
     fParticleGun->GeneratePrimaryVertex(anEvent);
+    SetEventWeight(anEvent, conesHeld, 2);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void PrimaryGeneratorAction::GenerateCascadeGammas(G4Event* anEvent)
 {
-    // Create G4LorentzVector with mass and excitation energy
-    // At rest at the cascade position
-    G4ParticleDefinition* ion = G4IonTable::GetIonTable()
-        ->GetIon(fIsotopeZ, fIsotopeA, 0.0);  // Ground state
-    G4double mass = ion->GetPDGMass();
-    G4double totalEnergy = mass + fExcitationEnergy * MeV;
-    G4LorentzVector momentum(0., 0., 0., totalEnergy);
-
-    // Create excited nucleus fragment
-    G4Fragment* excitedNucleus = new G4Fragment(
-        fIsotopeA,           // Mass number
-        fIsotopeZ,           // Atomic number
-        momentum             // 4-momentum (at rest + excitation)
-    );
-
-    // Generate cascade gammas using G4CASCADE
-    G4ReactionProductVector* cascadeProducts = nullptr;
-
-    if(fCascadeGenerator->HasData(fIsotopeZ, fIsotopeA)) {
-        cascadeProducts = fCascadeGenerator->GetGammas(
-            *excitedNucleus,
-            false,  // UseRawExcitation = false (fixed excitation)
-            false   // doUnplaced = false (ignore unplaced gammas)
-        );
-    } else {
+    if(!fCascadeGenerator->HasData(fIsotopeZ, fIsotopeA)) {
         G4cerr << "ERROR: No CASCADE data for Z=" << fIsotopeZ
                << " A=" << fIsotopeA << G4endl;
-        delete excitedNucleus;
         return;
     }
 
-    // Add all cascade gammas to the event
-    if(cascadeProducts) {
-        for(size_t i = 0; i < cascadeProducts->size(); i++) {
-            G4ReactionProduct* product = (*cascadeProducts)[i];
-
-            // Only add gammas (skip electrons from internal conversion)
-            if(product->GetDefinition() == G4Gamma::Gamma()) {
-                fParticleGun->SetParticleDefinition(
-                    const_cast<G4ParticleDefinition*>(product->GetDefinition()));
-
-                // Get momentum vector
-                G4ThreeVector momentum = product->GetMomentum();
-                G4double energy = momentum.mag();
-                G4ThreeVector direction = momentum.unit();
-
-                fParticleGun->SetParticleEnergy(energy);
-                fParticleGun->SetParticleMomentumDirection(direction);
-                fParticleGun->SetParticlePosition(fCascadePosition);
-
-                fParticleGun->GeneratePrimaryVertex(anEvent);
-            }
-        }
-
-        // Clean up
-        for(auto* product : *cascadeProducts) {
-            delete product;
-        }
-        delete cascadeProducts;
+    // Excited nucleus at rest at the cascade position; rebuilt only when the
+    // isotope or the excitation energy changes, which also drops the cascades
+    // pre-generated for the old one
+    if (fIsotopeZ != fCascadeNucleusZ || fIsotopeA != fCascadeNucleusA ||
+        fExcitationEnergy != fCascadeNucleusEx) {
+        G4ParticleDefinition* ion = G4IonTable::GetIonTable()
+            ->GetIon(fIsotopeZ, fIsotopeA, 0.0);  // Ground state
+        G4double mass = ion->GetPDGMass();
+        G4double totalEnergy = mass + fExcitationEnergy * MeV;
+        G4LorentzVector momentum(0., 0., 0., totalEnergy);
+        fCascadeNucleus = G4Fragment(
+            fIsotopeA,           // Mass number
+            fIsotopeZ,           // Atomic number
+            momentum             // 4-momentum (at rest + excitation)
+        );
+        fCascadeNucleusZ = fIsotopeZ;
+        fCascadeNucleusA = fIsotopeA;
+        fCascadeNucleusEx = fExcitationEnergy;
+        fCascadeBlock.Invalidate();
     }
 
-    delete excitedNucleus;
+    // Take the next cascade of the pre-generated block (refilled when used up)
+    G4int cascade = fCascadeBlock.NextCascade(*fCascadeGenerator, fCascadeNucleus);
+
+    // All gammas of the cascade share one primary vertex. G4CASCADE emits
+    // every particle isotropically and independently, so with -bias-cones
+    // only the chosen gamma needs a new direction; the weight depends on
+    // where all of them go.
+    const EmissionBiasing* biasing = EmissionBiasing::Instance();
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(fCascadePosition, 0.);
+    G4int first = fCascadeBlock.Offset(cascade);
+    G4int multiplicity = fCascadeBlock.Multiplicity(cascade);
+    G4int biased = first + biasing->ChooseBiasedPrimary(multiplicity);
+    G4int conesHeld = 0;
+    for(G4int i = first; i < first + multiplicity; i++) {
+        G4PrimaryParticle* gamma = new G4PrimaryParticle(G4Gamma::Gamma());
+        gamma->SetKineticEnergy(fCascadeBlock.Energy(i));
+        G4ThreeVector direction = i == biased ? biasing->SampleConeDirection()
+                                              : fCascadeBlock.Direction(i);
+        if (biasing->IsActive()) conesHeld += biasing->ConesHolding(direction);
+        gamma->SetMomentumDirection(direction);
+        vertex->SetPrimary(gamma);
+    }
+    anEvent->AddPrimaryVertex(vertex);
+    SetEventWeight(anEvent, conesHeld, multiplicity);
 
     // Debug output every 1000 events
     if(anEvent->GetEventID() % 50000 == 0 && !g_quietMode) {
@@ -352,16 +381,36 @@ G4ThreeVector PrimaryGeneratorAction::SampleSourcePosition()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-G4ThreeVector PrimaryGeneratorAction::SampleDirection()
+G4ThreeVector PrimaryGeneratorAction::SampleDirection(G4bool inCone, G4int& conesHeld)
 {
+    const EmissionBiasing* biasing = EmissionBiasing::Instance();
+    if (inCone) {
+        G4ThreeVector direction = biasing->SampleConeDirection();
+        conesHeld += biasing->ConesHolding(direction);
+        return direction;
+    }
+
     // Isotropic emission direction
     G4double cosTheta = 2.*G4UniformRand() - 1.;
     G4double sinTheta = std::sqrt(1. - cosTheta*cosTheta);
     G4double phi = twopi*G4UniformRand();
 
-    return G4ThreeVector(sinTheta*std::cos(phi),
-                        sinTheta*std::sin(phi),
-                        cosTheta);
+    G4ThreeVector direction(sinTheta*std::cos(phi),
+                            sinTheta*std::sin(phi),
+                            cosTheta);
+    if (biasing->IsActive()) conesHeld += biasing->ConesHolding(direction);
+    return direction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetEventWeight(G4Event* anEvent, G4int conesHeld, G4int nPrimaries)
+{
+    // The weight of the first vertex is the weight of the event (see
+    // EventAction::EventWeight)
+    G4double weight = EmissionBiasing::Instance()->EventWeight(conesHeld, nPrimaries);
+    if (weight == 1. || anEvent->GetNumberOfPrimaryVertex() == 0) return;
+    anEvent->GetPrimaryVertex(0)->SetWeight(weight);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -373,92 +422,211 @@ void PrimaryGeneratorAction::InitializeRAINIERFile()
         return;
     }
 
-    // Open ROOT file
-    fRAINIERRootFile = TFile::Open(fRAINIERFile.c_str(), "READ");
-    if (!fRAINIERRootFile || fRAINIERRootFile->IsZombie()) {
-        G4cerr << "ERROR: Cannot open RAINIER ROOT file: " << fRAINIERFile << G4endl;
-        fRAINIERRootFile = nullptr;
+    // The files were expanded and checked in main(); an action created
+    // some other way checks them here
+    RAINIERFileList* fileList = RAINIERFileList::Instance();
+    if (!fileList->IsOpen() && !fileList->Open(fRAINIERFile)) {
         return;
     }
 
-    // Get tree
-    fRAINIERTree = (TTree*)fRAINIERRootFile->Get("tree");
-    if (!fRAINIERTree) {
-        G4cerr << "ERROR: Cannot find 'tree' in RAINIER file: " << fRAINIERFile << G4endl;
-        fRAINIERRootFile->Close();
-        delete fRAINIERRootFile;
-        fRAINIERRootFile = nullptr;
-        return;
-    }
+    // This thread reads its own range of entries, from the files that hold
+    // it, so no two threads decompress the same baskets; the chains of
+    // other ranges are opened only if it has to help with them
+    fRAINIERChains.assign(fileList->GetNumberOfRanges(), nullptr);
+    fRAINIERHomeRange = fileList->GetHomeRange(G4Threading::G4GetThreadId());
+    fRAINIERTotalEntries = fileList->GetSize();
+    fRAINIERCurrentEntry = 0;
+    fRAINIERChunkEnd = 0;
+    fRAINIERChunkRange = -1;
+    fRAINIERExhausted = false;
 
-    fRAINIERTotalEntries = fRAINIERTree->GetEntries();
+    // Entry counts for the end-of-run report of distinct cascades
+    RAINIERCursor::Instance()->Attach(fRAINIERTotalEntries);
 
-    // Set up branch addresses
-    fRAINIEREgs = nullptr;
-    fRAINIERExfs = nullptr;
-    fRAINIERTree->SetBranchAddress("Egs", &fRAINIEREgs);
-    fRAINIERTree->SetBranchAddress("Exfs", &fRAINIERExfs);
+    G4long first, end;
+    fileList->GetRange(fRAINIERHomeRange, first, end);
+    if (first < end) OpenRAINIERChain(fRAINIERHomeRange);
 
     if (!g_quietMode) {
         G4cout << "\n========================================" << G4endl;
         G4cout << "  RAINIER ROOT File Initialized" << G4endl;
         G4cout << "========================================" << G4endl;
-        G4cout << "File: " << fRAINIERFile << G4endl;
-        G4cout << "Total cascade events: " << fRAINIERTotalEntries << G4endl;
+        G4cout << "Files: " << fileList->GetFiles().size()
+               << " (" << fileList->GetFiles().front() << (fileList->GetFiles().size() > 1 ? ", ..." : "") << ")" << G4endl;
+        if (first < end) {
+            G4cout << (fileList->HasIndex() ? "Accepted entries" : "Entries") << " read first by this thread: "
+                   << first << " - " << end - 1 << " of " << fRAINIERTotalEntries << G4endl;
+        } else {
+            G4cout << "No entries of its own for this thread; it helps the others" << G4endl;
+        }
         G4cout << "========================================\n" << G4endl;
     }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+PrimaryGeneratorAction::RAINIERChain* PrimaryGeneratorAction::OpenRAINIERChain(G4int range)
+{
+    if (fRAINIERChains[range]) return fRAINIERChains[range];
+
+    const RAINIERFileList* fileList = RAINIERFileList::Instance();
+    G4long first, end, offset;
+    fileList->GetRange(range, first, end);
+    std::vector<std::string> files = fileList->FilesInRange(first, end, offset);
+
+    RAINIERChain* chain = new RAINIERChain();
+    TChain* tree = new TChain(fileList->GetTreeName().c_str());
+    for (const std::string& file : files) {
+        tree->Add(file.c_str());
+    }
+    chain->tree = tree;
+    chain->egs = nullptr;
+    chain->exfs = nullptr;
+    chain->offset = offset;
+
+    // Set up branch addresses; only Egs is used, and Exfs for a level
+    // criterion unless the index has applied it already
+    chain->tree->SetBranchStatus("*", 0);
+    chain->tree->SetBranchStatus("Egs", 1);
+    chain->tree->SetBranchAddress("Egs", &chain->egs);
+    if (CascadeFilter::Instance()->NeedsLevels() && !fileList->HasIndex()) {
+        chain->tree->SetBranchStatus("Exfs", 1);
+        chain->tree->SetBranchAddress("Exfs", &chain->exfs);
+    }
+
+    fRAINIERChains[range] = chain;
+    return chain;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Long64_t PrimaryGeneratorAction::NextRAINIERPosition()
+{
+    // Positions of preloaded cascades come in chunks from the cursor shared
+    // by all workers, so no cascade is used twice before all of them have
+    // been used once
+    if (fRAINIERCurrentEntry >= fRAINIERChunkEnd) {
+        G4long first, end;
+        if (!RAINIERCursor::Instance()->NextChunk(first, end)) {
+            G4cerr << "ERROR: RAINIER entry cursor not initialized!" << G4endl;
+            return -1;
+        }
+        fRAINIERCurrentEntry = first;
+        fRAINIERChunkEnd = end;
+    }
+    return fRAINIERCurrentEntry++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 bool PrimaryGeneratorAction::GetNextRAINIERCascade()
 {
-    if (!fRAINIERTree) {
+    RAINIERCursor* cursor = RAINIERCursor::Instance();
+
+    // Streamed cascades have passed the selection in the reader thread
+    if (fRAINIERStream) {
+        G4long position;
+        if (!fRAINIERStream->Pop(fRAINIERStreamCascade, position)) return false;
+        fRAINIERCascade = fRAINIERStreamCascade.data();
+        fRAINIERCascadeSize = fRAINIERStreamCascade.size();
+        cursor->RecordUsed(position);
+        return true;
+    }
+
+    // Preloaded cascades have passed the selection already. Cascades of a
+    // text list with intensities are drawn by intensity, the others taken
+    // in this thread's random order (-rainier-sample) or in file order.
+    if (fRAINIERStore && fRAINIERStore->IsWeighted()) {
+        G4long cascade = fRAINIERStore->Sample(G4UniformRand());
+        fRAINIERCascade = fRAINIERStore->Energies(cascade);
+        fRAINIERCascadeSize = fRAINIERStore->NumberOfGammas(cascade);
+        cursor->RecordUsed(cascade);
+        return true;
+    }
+    if (fRAINIERSampler) {
+        G4long position;
+        G4long cascade = fRAINIERSampler->Next(position);
+        if (cascade < 0) return false;
+        fRAINIERCascade = fRAINIERStore->Energies(cascade);
+        fRAINIERCascadeSize = fRAINIERStore->NumberOfGammas(cascade);
+        cursor->RecordUsed(position);
+        return true;
+    }
+    if (fRAINIERStore) {
+        Long64_t position = NextRAINIERPosition();
+        if (position < 0) return false;
+        G4long cascade = position % fRAINIERStore->GetNumberOfCascades();
+        fRAINIERCascade = fRAINIERStore->Energies(cascade);
+        fRAINIERCascadeSize = fRAINIERStore->NumberOfGammas(cascade);
+        cursor->RecordUsed(position);
+        return true;
+    }
+
+    if (fRAINIERChains.empty()) {
         G4cerr << "ERROR: RAINIER tree not initialized!" << G4endl;
         return false;
     }
-
-    // Loop through entries to find next valid cascade
-    // (with at least 1 gamma, or exactly 2 gammas with E_total > 5.4 MeV if filter enabled)
-    while (fRAINIERCurrentEntry < fRAINIERTotalEntries) {
-        fRAINIERTree->GetEntry(fRAINIERCurrentEntry++);
-
-        // Check if this cascade meets the filter criteria
-        if (fRAINIEREgs && fRAINIEREgs->size() > 0) {
-            // Apply 2-gamma filter if enabled
-            if (fTwoGammaOnly) {
-                if (fRAINIEREgs->size() == 2) {
-                    // Check total energy: sum of both gammas must be > 5.4 MeV
-                    G4double totalEnergy = (*fRAINIEREgs)[0] + (*fRAINIEREgs)[1];
-                    if (totalEnergy > 5.4) {
-                        return true;  // Found valid 2-gamma cascade with E_total > 5.4 MeV
-                    } else {
-                        fRAINIEREmptyCount++;  // Count filtered cascades (low energy)
-                    }
-                } else {
-                    fRAINIEREmptyCount++;  // Count filtered cascades
-                }
-            } else {
-                return true;  // Found valid cascade (any multiplicity)
+    if (fRAINIERExhausted) return false;
+
+    // Take entries in chunks from RAINIERFileList, which hands out this
+    // thread's range first and then helps with the ranges other threads
+    // have not finished, so that a pass over all entries ends before the
+    // next one starts. With an index only accepted entries are read.
+    const CascadeFilter* filter = CascadeFilter::Instance();
+    RAINIERFileList* fileList = RAINIERFileList::Instance();
+    for (;;) {
+        if (fRAINIERCurrentEntry >= fRAINIERChunkEnd) {
+            if (fRAINIERChunkRange >= 0) {
+                fileList->ChunkDone(fRAINIERChunkRange, fRAINIERChunkPass,
+                                    fRAINIERChunkEnd - fRAINIERChunkFirst, fRAINIERChunkAccepted);
             }
-        } else {
-            fRAINIEREmptyCount++;  // Count empty cascades
+            G4int range;
+            G4long first, end, pass;
+            if (!fileList->NextChunk(fRAINIERHomeRange, range, first, end, pass)) {
+                // Every entry was read once without an accepted cascade: end
+                // the run instead of generating empty events
+                G4cerr << "ERROR: No usable cascade in the " << fRAINIERTotalEntries << " RAINIER entries of "
+                       << fRAINIERFile
+                       << (filter->IsActive() ? " (filter " + filter->GetDescription() + ")" : "") << G4endl;
+                fRAINIERExhausted = true;
+                fRAINIERChunkRange = -1;
+                G4RunManager::GetRunManager()->AbortRun(true);
+                return false;
+            }
+            fRAINIERChunkRange = range;
+            fRAINIERChunkPass = pass;
+            fRAINIERChunkFirst = first;
+            fRAINIERCurrentEntry = first;
+            fRAINIERChunkEnd = end;
+            fRAINIERChunkAccepted = false;
         }
-    }
 
-    // Reached end of file - wrap around to beginning
-    if (!g_quietMode) {
-        G4cout << "Reached end of RAINIER file. Wrapping to beginning..." << G4endl;
+        RAINIERChain* chain = OpenRAINIERChain(fRAINIERChunkRange);
+        Long64_t position = fRAINIERCurrentEntry++;
+        chain->tree->GetEntry(fileList->GetEntry(position) - chain->offset);
+
+        // Exfs ends with the level the cascade stops at; the rest are intermediate
+        size_t nLevels = chain->exfs && !chain->exfs->empty() ? chain->exfs->size() - 1 : 0;
+        if (chain->egs &&
+            (fileList->HasIndex() ||
+             filter->Accept(chain->egs->data(), chain->egs->size(),
+                            chain->exfs ? chain->exfs->data() : nullptr, nLevels))) {
+            fRAINIERCascade = chain->egs->data();
+            fRAINIERCascadeSize = chain->egs->size();
+            fRAINIERChunkAccepted = true;
+            cursor->RecordUsed(fRAINIERChunkPass * fRAINIERTotalEntries + position);
+            return true;
+        }
+        fRAINIEREmptyCount++;  // Count empty and filtered cascades
+        cursor->RecordSkipped();
     }
-    fRAINIERCurrentEntry = 0;
-    return GetNextRAINIERCascade();  // Recursive call to get first valid entry
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void PrimaryGeneratorAction::GenerateRAINIERCascade(G4Event* anEvent)
 {
-    // Get next valid cascade from RAINIER file
+    // Get next valid cascade from RAINIER file or the preloaded store
     if (!GetNextRAINIERCascade()) {
         G4cerr << "ERROR: Failed to read RAINIER cascade!" << G4endl;
         return;
@@ -466,25 +634,29 @@ void PrimaryGeneratorAction::GenerateRAINIERCascade(G4Event* anEvent)
 
     // Get source position (same for all gammas in cascade)
     G4ThreeVector sourcePos = SampleSourcePosition();
+    G4int nGammas = (G4int)fRAINIERCascadeSize;
+    G4int biased = EmissionBiasing::Instance()->ChooseBiasedPrimary(nGammas);
+    G4int conesHeld = 0;
 
     // Generate all gamma rays from this cascade
-    for (size_t i = 0; i < fRAINIEREgs->size(); i++) {
-        G4double gammaEnergy = (*fRAINIEREgs)[i] * MeV;
+    for (size_t i = 0; i < fRAINIERCascadeSize; i++) {
+        G4double gammaEnergy = fRAINIERCascade[i] * MeV;
 
         // Set particle properties
         fParticleGun->SetParticleEnergy(gammaEnergy);
         fParticleGun->SetParticlePosition(sourcePos);
-        fParticleGun->SetParticleMomentumDirection(SampleDirection());
+        fParticleGun->SetParticleMomentumDirection(SampleDirection((G4int)i == biased, conesHeld));
         fParticleGun->SetParticleTime(0.0);  // All gammas at t=0 (instant cascade)
 
         // Add gamma to event
         fParticleGun->GeneratePrimaryVertex(anEvent);
     }
+    SetEventWeight(anEvent, conesHeld, nGammas);
 
     // Debug output every 1000 events
     if (anEvent->GetEventID() % 50000 == 0 && !g_quietMode) {
         G4cout << "Event " << anEvent->GetEventID()
-               << ": Generated " << fRAINIEREgs->size()
+               << ": Generated " << fRAINIERCascadeSize
                << " gammas from RAINIER cascade" << G4endl;
     }
 }
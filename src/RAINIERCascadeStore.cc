@@ -0,0 +1,238 @@
+// ==============================================================================
+// RAINIERCascadeStore.cc - RAINIER cascades preloaded into one flat buffer
+// ==============================================================================
+
+#include "RAINIERCascadeStore.hh"
+#include "CascadeFilter.hh"
+#include "RAINIERTextReader.hh"
+
+// ROOT configuration must see std::string_view support before including TFile/TTree
+#include "RConfigure.h"
+#ifndef R__HAS_STD_STRING_VIEW
+#define R__HAS_STD_STRING_VIEW 1
+#endif
+
+#include "TChain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+// External global variable for quiet mode
+extern bool g_quietMode;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERCascadeStore::RAINIERCascadeStore()
+: fOffsets(1, 0),
+  fEntriesRead(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+struct RAINIERCascadeStore::Batch
+{
+  std::vector<G4double> energies;
+  std::vector<G4long> offsets;
+  std::vector<G4double> levels;
+  std::vector<G4long> levelOffsets;
+  std::vector<G4double> intensities;
+  std::vector<char> pass;
+
+  Batch() : offsets(1, 0), levelOffsets(1, 0) {}
+  G4long Size() const { return (G4long)offsets.size() - 1; }
+  void Clear()
+  {
+    energies.clear();
+    offsets.resize(1);
+    levels.clear();
+    levelOffsets.resize(1);
+    intensities.clear();
+  }
+};
+
+void RAINIERCascadeStore::AddBatch(const CascadeFilter& filter, Batch& batch,
+                                   std::vector<G4double>* intensities)
+{
+  G4long n = batch.Size();
+  if (n == 0) return;
+  filter.Evaluate(batch.energies.data(), batch.offsets.data(),
+                  filter.NeedsLevels() ? batch.levels.data() : nullptr, batch.levelOffsets.data(),
+                  n, batch.pass);
+  for (G4long c = 0; c < n; c++) {
+    if (!batch.pass[c]) continue;
+    fEnergies.insert(fEnergies.end(), batch.energies.begin() + batch.offsets[c],
+                     batch.energies.begin() + batch.offsets[c+1]);
+    fOffsets.push_back((G4long)fEnergies.size());
+    if (intensities) intensities->push_back(batch.intensities[c]);
+  }
+  batch.Clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERCascadeStore* RAINIERCascadeStore::Load(const std::vector<std::string>& files,
+                                               const std::string& treeName, const CascadeFilter& filter,
+                                               const std::vector<G4long>* entries)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  // The files have been checked by RAINIERFileList
+  std::unique_ptr<TChain> tree(new TChain(treeName.c_str()));
+  for (const std::string& file : files) {
+    tree->Add(file.c_str());
+  }
+
+  // Only Egs is used, and Exfs for a level criterion unless the index has
+  // applied it already; no other branch is deserialized
+  std::vector<Double_t>* egs = nullptr;
+  std::vector<Double_t>* exfs = nullptr;
+  tree->SetBranchStatus("*", 0);
+  tree->SetBranchStatus("Egs", 1);
+  tree->SetBranchAddress("Egs", &egs);
+  if (filter.NeedsLevels() && !entries) {
+    tree->SetBranchStatus("Exfs", 1);
+    tree->SetBranchAddress("Exfs", &exfs);
+  }
+
+  std::unique_ptr<RAINIERCascadeStore> store(new RAINIERCascadeStore);
+  Batch batch;
+  Long64_t nEntries = entries ? (Long64_t)entries->size() : tree->GetEntries();
+  for (Long64_t i = 0; i < nEntries; i++) {
+    if (entries) {
+      tree->GetEntry((*entries)[i]);
+      if (!egs) continue;
+      store->fEnergies.insert(store->fEnergies.end(), egs->begin(), egs->end());
+      store->fOffsets.push_back((G4long)store->fEnergies.size());
+      continue;
+    }
+    tree->GetEntry(i);
+    if (egs) batch.energies.insert(batch.energies.end(), egs->begin(), egs->end());
+    batch.offsets.push_back((G4long)batch.energies.size());
+    // Exfs ends with the level the cascade stops at; the rest are intermediate
+    if (exfs && !exfs->empty()) batch.levels.insert(batch.levels.end(), exfs->begin(), exfs->end() - 1);
+    batch.levelOffsets.push_back((G4long)batch.levels.size());
+    if (batch.Size() == kBatchSize) store->AddBatch(filter, batch, nullptr);
+  }
+  store->AddBatch(filter, batch, nullptr);
+  store->fEntriesRead = nEntries;
+  tree->ResetBranchAddresses();
+  delete egs;
+  delete exfs;
+  tree.reset();
+
+  store->fEnergies.shrink_to_fit();
+  store->fOffsets.shrink_to_fit();
+
+  if (store->GetNumberOfCascades() == 0) {
+    G4cerr << "ERROR: No usable cascade in " << files.size() << " RAINIER file"
+           << (files.size() == 1 ? "" : "s")
+           << (filter.IsActive() ? " (filter " + filter.GetDescription() + ")" : "") << G4endl;
+    return nullptr;
+  }
+
+  if (!g_quietMode) {
+    G4double seconds = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+    G4cout << "RAINIER preload: " << store->GetNumberOfCascades() << " of " << nEntries
+           << " cascades accepted, " << store->GetNumberOfGammas() << " gammas, "
+           << store->MemoryUsage() / 1048576. << " MB, " << seconds << " s" << G4endl;
+  }
+  return store.release();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERCascadeStore* RAINIERCascadeStore::LoadText(const std::string& fileName, const CascadeFilter& filter)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  RAINIERTextReader reader(fileName);
+  if (!reader.IsOpen()) {
+    G4cerr << "ERROR: Cannot open RAINIER text file: " << fileName << G4endl;
+    return nullptr;
+  }
+
+  std::unique_ptr<RAINIERCascadeStore> store(new RAINIERCascadeStore);
+  std::vector<G4double> intensities;
+  std::vector<G4double> energies;
+  G4double intensity;
+  Batch batch;
+  G4long nCascades = 0;
+  while (reader.Next(energies, intensity)) {
+    nCascades++;
+    if (!(intensity > 0.) || !std::isfinite(intensity)) continue;
+    if (*std::min_element(energies.begin(), energies.end()) <= 0.) continue;
+    batch.energies.insert(batch.energies.end(), energies.begin(), energies.end());
+    batch.offsets.push_back((G4long)batch.energies.size());
+    batch.levelOffsets.push_back(0);
+    batch.intensities.push_back(intensity);
+    if (batch.Size() == kBatchSize) store->AddBatch(filter, batch, &intensities);
+  }
+  store->AddBatch(filter, batch, &intensities);
+  store->fEntriesRead = nCascades;
+
+  store->fEnergies.shrink_to_fit();
+  store->fOffsets.shrink_to_fit();
+
+  if (store->GetNumberOfCascades() == 0) {
+    G4cerr << "ERROR: No usable cascade in RAINIER text file " << fileName
+           << (filter.IsActive() ? " (filter " + filter.GetDescription() + ")" : "") << G4endl;
+    return nullptr;
+  }
+  store->BuildAliasTable(intensities);
+
+  if (!g_quietMode) {
+    G4double seconds = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+    G4cout << "RAINIER text: " << store->GetNumberOfCascades() << " of " << nCascades
+           << " cascades accepted" << (store->IsWeighted() ? " (weighted by intensity)" : "")
+           << ", " << store->GetNumberOfGammas() << " gammas, "
+           << store->MemoryUsage() / 1048576. << " MB, " << reader.GetBytesRead() / 1048576. / seconds
+           << " MB/s" << G4endl;
+    if (reader.GetBadLines() > 0) {
+      G4cout << "  " << reader.GetBadLines() << " lines could not be parsed and were skipped" << G4endl;
+    }
+  }
+  return store.release();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Walker alias table (Vose's method) over the cascade intensities
+void RAINIERCascadeStore::BuildAliasTable(const std::vector<G4double>& intensities)
+{
+  G4long n = (G4long)intensities.size();
+  G4bool equal = true;
+  G4double sum = 0.;
+  for (G4long i = 0; i < n; i++) {
+    sum += intensities[i];
+    if (intensities[i] != intensities[0]) equal = false;
+  }
+  fCut.clear();
+  fAlias.clear();
+  if (equal) return;
+
+  fCut.assign(n, 1.);
+  fAlias.resize(n);
+  std::vector<G4double> scaled(n);
+  std::vector<G4long> small, large;
+  for (G4long i = 0; i < n; i++) {
+    fAlias[i] = i;
+    scaled[i] = intensities[i] * n / sum;
+    (scaled[i] < 1. ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    G4long s = small.back(); small.pop_back();
+    G4long l = large.back();
+    fCut[s] = scaled[s];
+    fAlias[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if (scaled[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // Left-overs are 1 up to rounding
+  for (G4long i : small) fCut[i] = 1.;
+  for (G4long i : large) fCut[i] = 1.;
+}
@@ -0,0 +1,121 @@
+// ==============================================================================
+// RAINIERCursor.cc - Process-wide hand-out of RAINIER tree entries
+// ==============================================================================
+
+#include "RAINIERCursor.hh"
+#include "G4AutoLock.hh"
+#include <bitset>
+
+// External global variable for quiet mode
+extern bool g_quietMode;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERCursor* RAINIERCursor::Instance()
+{
+  static RAINIERCursor instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERCursor::RAINIERCursor()
+: fTotalEntries(0),
+  fNext(0),
+  fNumberOfWords(0),
+  fUsed(0),
+  fSkipped(0),
+  fPass(0)
+{}
+
+RAINIERCursor::~RAINIERCursor()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERCursor::Attach(G4long totalEntries)
+{
+  G4AutoLock lock(&fMutex);
+  G4long known = fTotalEntries.load(std::memory_order_relaxed);
+  if (known > 0) return known == totalEntries;
+  if (totalEntries <= 0) return false;
+
+  fNumberOfWords = (totalEntries + 63) / 64;
+  fUsedBits.reset(new std::atomic<std::uint64_t>[fNumberOfWords]);
+  for (G4long i = 0; i < fNumberOfWords; i++) fUsedBits[i].store(0, std::memory_order_relaxed);
+  fTotalEntries.store(totalEntries, std::memory_order_release);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERCursor::NextChunk(G4long& first, G4long& end)
+{
+  if (GetTotalEntries() <= 0) return false;
+  first = fNext.fetch_add(kDefaultChunkSize, std::memory_order_relaxed);
+  end = first + kDefaultChunkSize;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERCursor::RecordUsed(G4long position)
+{
+  G4long total = GetTotalEntries();
+  if (total <= 0 || position < 0) return;
+  fUsed.fetch_add(1, std::memory_order_relaxed);
+
+  G4long entry = position % total;
+  fUsedBits[entry / 64].fetch_or(std::uint64_t(1) << (entry % 64), std::memory_order_relaxed);
+
+  // Only the first worker to enter a new pass reports it
+  G4long pass = position / total;
+  G4long known = fPass.load(std::memory_order_relaxed);
+  while (pass > known) {
+    if (fPass.compare_exchange_weak(known, pass, std::memory_order_relaxed)) {
+      if (!g_quietMode) {
+        G4cout << "All RAINIER cascades used once more; starting pass "
+               << pass + 1 << G4endl;
+      }
+      break;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long RAINIERCursor::GetUniqueCascades() const
+{
+  G4long unique = 0;
+  for (G4long i = 0; i < fNumberOfWords; i++) {
+    unique += std::bitset<64>(fUsedBits[i].load(std::memory_order_relaxed)).count();
+  }
+  return unique;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Number of times an entry was used again after the last entry of the tree
+G4long RAINIERCursor::GetWraparounds() const
+{
+  return fPass.load(std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERCursor::PrintStatistics() const
+{
+  G4long total = GetTotalEntries();
+  if (total <= 0 || GetCascadesUsed() + GetSkipped() == 0) return;
+
+  G4long wraps = GetWraparounds();
+  G4cout << "RAINIER entries: " << GetCascadesUsed() << " cascades used, "
+         << GetUniqueCascades() << " of " << total << " distinct, "
+         << GetSkipped() << " skipped; ";
+  if (wraps == 0) {
+    G4cout << "no wraparound" << G4endl;
+  } else {
+    G4cout << "wrapped to the first entry " << wraps << " time"
+           << (wraps == 1 ? "" : "s") << G4endl;
+  }
+}
@@ -0,0 +1,343 @@
+// ==============================================================================
+// RAINIERFileList.cc - The RAINIER files of a run and their split by thread
+// ==============================================================================
+
+#include "RAINIERFileList.hh"
+#include "CascadeFilter.hh"
+#include "RAINIERCursor.hh"
+#include "RAINIERIndex.hh"
+
+// ROOT configuration must see std::string_view support before including TFile/TTree
+#include "RConfigure.h"
+#ifndef R__HAS_STD_STRING_VIEW
+#define R__HAS_STD_STRING_VIEW 1
+#endif
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <glob.h>
+
+// External global variable for quiet mode
+extern bool g_quietMode;
+
+const char* const RAINIERFileList::kDefaultTreeName = "tree";
+
+namespace {
+
+G4bool EndsWith(const std::string& s, const std::string& suffix)
+{
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+G4bool HasWildcard(const std::string& s)
+{
+  return s.find_first_of("*?[") != std::string::npos;
+}
+
+// Paths matching pattern in sorted order (glob sorts them), or pattern
+// itself if it has no wildcard
+std::vector<std::string> Glob(const std::string& pattern)
+{
+  std::vector<std::string> paths;
+  if (!HasWildcard(pattern)) {
+    paths.push_back(pattern);
+    return paths;
+  }
+  glob_t matches;
+  if (glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+    for (size_t i = 0; i < matches.gl_pathc; i++) paths.push_back(matches.gl_pathv[i]);
+  }
+  globfree(&matches);
+  return paths;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERFileList* RAINIERFileList::Instance()
+{
+  static RAINIERFileList instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERFileList::RAINIERFileList()
+: fTreeName(kDefaultTreeName),
+  fIndexed(false),
+  fNumberOfRanges(0)
+{}
+
+RAINIERFileList::~RAINIERFileList()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<std::string> RAINIERFileList::Expand(const std::string& spec)
+{
+  if (!EndsWith(spec, ".list") && !EndsWith(spec, ".txt")) return Glob(spec);
+
+  std::vector<std::string> paths;
+  std::ifstream list(spec);
+  if (!list.is_open()) {
+    G4cerr << "ERROR: Cannot open RAINIER file list: " << spec << G4endl;
+    return paths;
+  }
+  std::string directory;
+  size_t slash = spec.find_last_of('/');
+  if (slash != std::string::npos) directory = spec.substr(0, slash + 1);
+
+  std::string line;
+  while (std::getline(list, line)) {
+    size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#') continue;
+    size_t end = line.find_last_not_of(" \t\r");
+    std::string pattern = line.substr(begin, end - begin + 1);
+    if (pattern[0] != '/') pattern = directory + pattern;
+
+    std::vector<std::string> matches = Glob(pattern);
+    if (matches.empty()) {
+      G4cerr << "ERROR: No file matches '" << pattern << "' in " << spec << G4endl;
+      return std::vector<std::string>();
+    }
+    paths.insert(paths.end(), matches.begin(), matches.end());
+  }
+  return paths;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERFileList::Open(const std::string& spec, const std::string& treeName)
+{
+  fFiles.clear();
+  fFirstEntry.assign(1, 0);
+  fIndexed = false;
+  fAccepted.clear();
+  fTreeName = treeName;
+
+  std::vector<std::string> paths = Expand(spec);
+  if (paths.empty()) {
+    G4cerr << "ERROR: No RAINIER file matches '" << spec << "'" << G4endl;
+    return false;
+  }
+
+  if (!g_quietMode) {
+    G4cout << "RAINIER input: " << paths.size() << " file" << (paths.size() == 1 ? "" : "s")
+           << ", tree '" << treeName << "'" << G4endl;
+  }
+
+  G4int bad = 0;
+  for (const std::string& path : paths) {
+    std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+    const char* problem = nullptr;
+    Long64_t entries = 0;
+    if (!file || file->IsZombie()) {
+      problem = "cannot be opened";
+    } else {
+      TTree* tree = dynamic_cast<TTree*>(file->Get(treeName.c_str()));
+      if (!tree) problem = "has no such tree";
+      else if (!tree->GetBranch("Egs")) problem = "has no Egs branch";
+      else if (CascadeFilter::Instance()->NeedsLevels() && !tree->GetBranch("Exfs")) {
+        problem = "has no Exfs branch, needed by the level criterion of the filter";
+      }
+      else if ((entries = tree->GetEntries()) <= 0) problem = "has no entries";
+    }
+    if (file) file->Close();
+
+    if (problem) {
+      G4cerr << "ERROR: RAINIER file " << path << " " << problem << G4endl;
+      bad++;
+      continue;
+    }
+    fFiles.push_back(path);
+    fFirstEntry.push_back(fFirstEntry.back() + entries);
+    if (!g_quietMode) {
+      G4cout << "  " << std::setw(12) << entries << "  " << path << G4endl;
+    }
+  }
+
+  if (bad > 0) {
+    G4cerr << "ERROR: " << bad << " of " << paths.size() << " RAINIER files failed the check" << G4endl;
+    fFiles.clear();
+    fFirstEntry.assign(1, 0);
+    return false;
+  }
+  if (!g_quietMode) {
+    G4cout << "  " << std::setw(12) << GetTotalEntries() << "  entries in total" << G4endl;
+  }
+  SetRanges(1);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERFileList::LoadIndex(const CascadeFilter& filter)
+{
+  std::vector<G4long> accepted;
+  std::vector<G4long> multiplicity(RAINIERIndex::kMultiplicityBins, 0);
+  G4int nRead = 0;
+  for (size_t i = 0; i < fFiles.size(); i++) {
+    std::unique_ptr<RAINIERIndex> index(RAINIERIndex::Open(fFiles[i], fTreeName, filter));
+    if (!index) return false;
+    if (index->GetTreeEntries() != fFirstEntry[i+1] - fFirstEntry[i]) {
+      G4cerr << "ERROR: RAINIER index of " << fFiles[i] << " has " << index->GetTreeEntries()
+             << " entries, the file " << fFirstEntry[i+1] - fFirstEntry[i] << G4endl;
+      return false;
+    }
+    for (G4long entry : index->GetEntries()) accepted.push_back(fFirstEntry[i] + entry);
+    for (G4int m = 0; m < RAINIERIndex::kMultiplicityBins; m++) multiplicity[m] += index->GetMultiplicity()[m];
+    if (index->WasRead()) nRead++;
+  }
+
+  if (accepted.empty()) {
+    G4cerr << "ERROR: No RAINIER entry passes the filter " << filter.GetDescription() << G4endl;
+    return false;
+  }
+  fAccepted.swap(accepted);
+  fIndexed = true;
+  SetRanges(fNumberOfRanges);
+
+  if (!g_quietMode) {
+    G4cout << "RAINIER index (" << nRead << " of " << fFiles.size() << " read, the rest built): "
+           << fAccepted.size() << " of " << GetTotalEntries() << " entries accepted";
+    if (filter.IsActive()) G4cout << " by " << filter.GetDescription();
+    G4cout << G4endl << "  gammas:cascades";
+    for (G4int m = 0; m < RAINIERIndex::kMultiplicityBins; m++) {
+      if (multiplicity[m] == 0) continue;
+      G4cout << "  " << m << (m == RAINIERIndex::kMultiplicityBins - 1 ? "+" : "") << ":" << multiplicity[m];
+    }
+    G4cout << G4endl;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERFileList::Assign(G4int nThreads)
+{
+  SetRanges(nThreads);
+  if (g_quietMode || fNumberOfRanges == 1 || !IsOpen()) return;
+
+  G4cout << "RAINIER entries per thread:" << G4endl;
+  for (G4int thread = 0; thread < fNumberOfRanges; thread++) {
+    G4long first, end, offset;
+    GetRange(thread, first, end);
+    G4cout << "  thread " << std::setw(3) << thread << ": ";
+    if (first >= end) {
+      G4cout << "none, takes chunks from the other threads" << G4endl;
+      continue;
+    }
+    size_t nFiles = FilesInRange(first, end, offset).size();
+    G4cout << (fIndexed ? "accepted " : "") << "entries " << first << " - " << end - 1
+           << " (" << nFiles << " file" << (nFiles == 1 ? "" : "s") << ")" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERFileList::SetRanges(G4int n)
+{
+  fNumberOfRanges = std::max(n, 1);
+  fRanges.reset(new Range[fNumberOfRanges]);
+  G4long total = GetSize();
+  for (G4int r = 0; r < fNumberOfRanges; r++) {
+    Range& range = fRanges[r];
+    range.first = total * r / fNumberOfRanges;
+    range.size = total * (r + 1) / fNumberOfRanges - range.first;
+    range.taken = 0;
+    range.firstPassRead = 0;
+    range.accepted = false;
+    // More threads than entries leaves some ranges without any
+    range.empty = (range.size == 0);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERFileList::GetRange(G4int range, G4long& first, G4long& end) const
+{
+  first = fRanges[range].first;
+  end = first + fRanges[range].size;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERFileList::NextChunk(G4int home, G4int& range, G4long& first, G4long& end, G4long& pass)
+{
+  for (;;) {
+    // A range is in pass p while it hands out the positions of pass p; the
+    // next pass starts once no range is left in this one
+    G4long minPass = -1;
+    for (G4int r = 0; r < fNumberOfRanges; r++) {
+      const Range& candidate = fRanges[r];
+      if (candidate.empty) continue;
+      G4long p = candidate.taken / candidate.size;
+      if (minPass < 0 || p < minPass) minPass = p;
+    }
+    if (minPass < 0) return false;
+
+    range = -1;
+    const Range& own = fRanges[home];
+    if (!own.empty && own.taken / own.size == minPass) {
+      range = home;
+    } else {
+      G4long mostLeft = 0;
+      for (G4int r = 0; r < fNumberOfRanges; r++) {
+        const Range& candidate = fRanges[r];
+        if (candidate.empty) continue;
+        G4long left = (minPass + 1) * candidate.size - candidate.taken;
+        if (left > mostLeft) {
+          mostLeft = left;
+          range = r;
+        }
+      }
+      if (range < 0) continue;
+    }
+
+    Range& chosen = fRanges[range];
+    G4long taken = chosen.taken;
+    if (taken / chosen.size != minPass) continue;
+    G4long chunkEnd = std::min(taken + RAINIERCursor::kDefaultChunkSize, (minPass + 1) * chosen.size);
+    if (!chosen.taken.compare_exchange_weak(taken, chunkEnd)) continue;
+
+    pass = minPass;
+    first = chosen.first + taken % chosen.size;
+    end = first + (chunkEnd - taken);
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERFileList::ChunkDone(G4int range, G4long pass, G4long size, G4bool accepted)
+{
+  Range& done = fRanges[range];
+  if (accepted) done.accepted = true;
+  if (pass != 0) return;
+  if (done.firstPassRead.fetch_add(size) + size == done.size && !done.accepted) {
+    done.empty = true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<std::string> RAINIERFileList::FilesInRange(G4long first, G4long end, G4long& offset) const
+{
+  std::vector<std::string> files;
+  offset = 0;
+  if (first >= end) return files;
+  G4long firstEntry = GetEntry(first);
+  G4long endEntry = GetEntry(end - 1) + 1;
+  for (size_t i = 0; i < fFiles.size(); i++) {
+    if (fFirstEntry[i+1] <= firstEntry || fFirstEntry[i] >= endEntry) continue;
+    if (files.empty()) offset = fFirstEntry[i];
+    files.push_back(fFiles[i]);
+  }
+  return files;
+}
@@ -0,0 +1,311 @@
+// ==============================================================================
+// RAINIERIndex.cc - Sidecar index of the RAINIER entries a filter accepts
+// ==============================================================================
+
+#include "RAINIERIndex.hh"
+#include "CascadeFilter.hh"
+
+// ROOT configuration must see std::string_view support before including TFile/TTree
+#include "RConfigure.h"
+#ifndef R__HAS_STD_STRING_VIEW
+#define R__HAS_STD_STRING_VIEW 1
+#endif
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+
+// External global variable for quiet mode
+extern bool g_quietMode;
+
+const G4double RAINIERIndex::kSumBinWidth = 0.1;
+
+namespace {
+
+const char kMagic[8] = { 'R', 'A', 'I', 'N', 'I', 'D', 'X', '1' };
+const uint32_t kVersion = 1;
+
+// Bytes at each end of the ROOT file that go into its checksum
+const size_t kStampBytes = 1 << 20;
+
+// Entries handed to the filter at a time while building
+const G4long kBatchSize = 4096;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t nMultiplicityBins;
+  uint32_t nSumBins;
+  uint32_t keyLength;
+  uint64_t fileSize;
+  uint64_t fileChecksum;
+  int64_t treeEntries;
+  int64_t accepted;
+  G4double sumBinWidth;
+  uint64_t checksum;
+};
+
+size_t Align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+// 64-bit FNV-1a
+uint64_t Checksum(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// "tree\nfilter": what an index was built for
+std::string KeyText(const std::string& treeName, const CascadeFilter& filter)
+{
+  return treeName + "\n" + filter.GetDescription();
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERIndex::RAINIERIndex()
+: fMultiplicity(kMultiplicityBins, 0),
+  fSum(kSumBins, 0),
+  fTreeEntries(0),
+  fWasRead(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string RAINIERIndex::SidecarPath(const std::string& path, const std::string& treeName,
+                                      const CascadeFilter& filter)
+{
+  std::string key = KeyText(treeName, filter);
+  char hash[17];
+  std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)Checksum(key.data(), key.size()));
+  return path + "." + hash + ".idx";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERIndex::FileStamp(const std::string& path, uint64_t& size, uint64_t& checksum)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file.is_open()) return false;
+  size = (uint64_t)file.tellg();
+  checksum = Checksum(&size, sizeof(size));
+
+  std::vector<char> bytes(std::min<uint64_t>(size, kStampBytes));
+  file.seekg(0);
+  file.read(bytes.data(), bytes.size());
+  checksum = Checksum(bytes.data(), bytes.size(), checksum);
+  if (size > kStampBytes) {
+    bytes.resize(std::min<uint64_t>(size - kStampBytes, kStampBytes));
+    file.seekg(size - bytes.size());
+    file.read(bytes.data(), bytes.size());
+    checksum = Checksum(bytes.data(), bytes.size(), checksum);
+  }
+  return (bool)file;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERIndex* RAINIERIndex::Open(const std::string& path, const std::string& treeName,
+                                 const CascadeFilter& filter)
+{
+  uint64_t fileSize, fileChecksum;
+  if (!FileStamp(path, fileSize, fileChecksum)) {
+    G4cerr << "ERROR: Cannot read RAINIER file " << path << G4endl;
+    return nullptr;
+  }
+
+  std::unique_ptr<RAINIERIndex> index(new RAINIERIndex);
+  std::string sidecar = SidecarPath(path, treeName, filter);
+  std::string key = KeyText(treeName, filter);
+  if (index->Read(sidecar, key, fileSize, fileChecksum)) return index.release();
+
+  if (!index->Build(path, treeName, filter)) return nullptr;
+  if (!index->Write(sidecar, key, fileSize, fileChecksum)) {
+    G4cerr << "WARNING: Cannot write RAINIER index " << sidecar << " (" << std::strerror(errno)
+           << "); it is built again by the next run" << G4endl;
+  }
+  return index.release();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERIndex::Read(const std::string& sidecar, const std::string& key,
+                          uint64_t fileSize, uint64_t fileChecksum)
+{
+  std::ifstream in(sidecar, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;   // no index yet: build it
+  uint64_t sidecarSize = (uint64_t)in.tellg();
+  in.seekg(0);
+
+  // A stale or damaged index is rebuilt, silently for a changed ROOT file.
+  // Nothing is allocated from the header before it is known to describe a
+  // file of exactly the size of the sidecar.
+  Header header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+      || header.nMultiplicityBins != (uint32_t)kMultiplicityBins
+      || header.nSumBins != (uint32_t)kSumBins || header.sumBinWidth != kSumBinWidth
+      || header.keyLength != key.size() || header.fileSize != fileSize
+      || header.fileChecksum != fileChecksum
+      || header.accepted < 0 || header.accepted > header.treeEntries) {
+    return false;
+  }
+  uint64_t sections = Align8(sizeof(header) + header.keyLength)
+                    + (uint64_t)(kMultiplicityBins + kSumBins) * sizeof(int64_t);
+  if (sidecarSize < sections || (uint64_t)header.accepted != (sidecarSize - sections) / sizeof(int64_t)
+      || (sidecarSize - sections) % sizeof(int64_t) != 0) {
+    G4cerr << "WARNING: RAINIER index " << sidecar << " is damaged, building it again" << G4endl;
+    return false;
+  }
+  std::string text(header.keyLength, '\0');
+  if (!in.read(&text[0], text.size()) || text != key) return false;
+  in.seekg(Align8(sizeof(header) + header.keyLength));
+
+  std::vector<int64_t> counts(kMultiplicityBins + kSumBins);
+  std::vector<int64_t> entries(header.accepted);
+  in.read(reinterpret_cast<char*>(counts.data()), counts.size() * sizeof(int64_t));
+  in.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(int64_t));
+  uint64_t checksum = Checksum(counts.data(), counts.size() * sizeof(int64_t));
+  checksum = Checksum(entries.data(), entries.size() * sizeof(int64_t), checksum);
+  if (!in || checksum != header.checksum) {
+    G4cerr << "WARNING: RAINIER index " << sidecar << " is damaged, building it again" << G4endl;
+    return false;
+  }
+
+  fMultiplicity.assign(counts.begin(), counts.begin() + kMultiplicityBins);
+  fSum.assign(counts.begin() + kMultiplicityBins, counts.end());
+  fEntries.assign(entries.begin(), entries.end());
+  fTreeEntries = header.treeEntries;
+  fWasRead = true;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERIndex::Build(const std::string& path, const std::string& treeName,
+                           const CascadeFilter& filter)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  // The file has been checked by RAINIERFileList
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  TTree* tree = file && !file->IsZombie() ? dynamic_cast<TTree*>(file->Get(treeName.c_str())) : nullptr;
+  if (!tree) {
+    G4cerr << "ERROR: Cannot read tree '" << treeName << "' of RAINIER file " << path << G4endl;
+    return false;
+  }
+
+  // Only Egs is read, and Exfs for a level criterion
+  std::vector<Double_t>* egs = nullptr;
+  std::vector<Double_t>* exfs = nullptr;
+  tree->SetBranchStatus("*", 0);
+  tree->SetBranchStatus("Egs", 1);
+  tree->SetBranchAddress("Egs", &egs);
+  if (filter.NeedsLevels()) {
+    tree->SetBranchStatus("Exfs", 1);
+    tree->SetBranchAddress("Exfs", &exfs);
+  }
+
+  // Entries go through the filter in batches, as in RAINIERCascadeStore
+  std::vector<G4double> energies, levels;
+  std::vector<G4long> offsets(1, 0), levelOffsets(1, 0);
+  std::vector<char> pass;
+  fTreeEntries = tree->GetEntries();
+  for (G4long first = 0; first < fTreeEntries; first += kBatchSize) {
+    G4long n = std::min(kBatchSize, fTreeEntries - first);
+    energies.clear();
+    levels.clear();
+    offsets.resize(1);
+    levelOffsets.resize(1);
+    for (G4long entry = first; entry < first + n; entry++) {
+      tree->GetEntry(entry);
+      if (egs) energies.insert(energies.end(), egs->begin(), egs->end());
+      offsets.push_back((G4long)energies.size());
+      // Exfs ends with the level the cascade stops at; the rest are intermediate
+      if (exfs && !exfs->empty()) levels.insert(levels.end(), exfs->begin(), exfs->end() - 1);
+      levelOffsets.push_back((G4long)levels.size());
+    }
+    filter.Evaluate(energies.data(), offsets.data(), filter.NeedsLevels() ? levels.data() : nullptr,
+                    levelOffsets.data(), n, pass);
+
+    for (G4long c = 0; c < n; c++) {
+      if (!pass[c]) continue;
+      fEntries.push_back(first + c);
+      G4long multiplicity = offsets[c+1] - offsets[c];
+      G4double sum = 0.;
+      for (G4long i = offsets[c]; i < offsets[c+1]; i++) sum += energies[i];
+      fMultiplicity[std::min<G4long>(multiplicity, kMultiplicityBins - 1)]++;
+      fSum[std::min<G4long>(std::max(sum / kSumBinWidth, 0.), kSumBins - 1)]++;
+    }
+  }
+  tree->ResetBranchAddresses();
+  delete egs;
+  delete exfs;
+  file->Close();
+
+  if (!g_quietMode) {
+    G4double seconds = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+    G4cout << "RAINIER index built for " << path << ": " << fEntries.size() << " of "
+           << fTreeEntries << " entries accepted, " << seconds << " s" << G4endl;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERIndex::Write(const std::string& sidecar, const std::string& key,
+                           uint64_t fileSize, uint64_t fileChecksum) const
+{
+  std::vector<int64_t> counts(fMultiplicity.begin(), fMultiplicity.end());
+  counts.insert(counts.end(), fSum.begin(), fSum.end());
+  std::vector<int64_t> entries(fEntries.begin(), fEntries.end());
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.nMultiplicityBins = kMultiplicityBins;
+  header.nSumBins = kSumBins;
+  header.keyLength = key.size();
+  header.fileSize = fileSize;
+  header.fileChecksum = fileChecksum;
+  header.treeEntries = fTreeEntries;
+  header.accepted = entries.size();
+  header.sumBinWidth = kSumBinWidth;
+  header.checksum = Checksum(counts.data(), counts.size() * sizeof(int64_t));
+  header.checksum = Checksum(entries.data(), entries.size() * sizeof(int64_t), header.checksum);
+
+  // Write to a temporary file and move it into place, so that another job
+  // never reads a half-written index; the name is private to this process,
+  // so jobs building the same index at once do not write into one file
+  std::string tmpPath = sidecar + "." + std::to_string(getpid()) + ".tmp";
+  std::ofstream out(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) return false;
+
+  const char padding[8] = { 0 };
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(key.data(), key.size());
+  out.write(padding, Align8(sizeof(header) + key.size()) - sizeof(header) - key.size());
+  out.write(reinterpret_cast<const char*>(counts.data()), counts.size() * sizeof(int64_t));
+  out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(int64_t));
+  out.close();
+
+  if (!out || std::rename(tmpPath.c_str(), sidecar.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
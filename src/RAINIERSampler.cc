@@ -0,0 +1,150 @@
+// ==============================================================================
+// RAINIERSampler.cc - Per-thread random order of preloaded RAINIER cascades
+// ==============================================================================
+
+#include "RAINIERSampler.hh"
+#include "RAINIERCascadeStore.hh"
+
+#include <algorithm>
+#include <map>
+
+namespace {
+
+struct Configuration {
+  RAINIERSampler::Mode mode;
+  uint64_t seed;
+  G4int nThreads;
+};
+
+Configuration& GetConfiguration()
+{
+  static Configuration configuration = { RAINIERSampler::kSequential, 0, 1 };
+  return configuration;
+}
+
+// SplitMix64 finalizer: nearby inputs give unrelated seeds
+uint64_t SplitMix64(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERSampler::Configure(Mode mode, uint64_t seed, G4int nThreads)
+{
+  Configuration& configuration = GetConfiguration();
+  configuration.mode = mode;
+  configuration.seed = seed;
+  configuration.nThreads = std::max(nThreads, 1);
+}
+
+RAINIERSampler::Mode RAINIERSampler::GetMode()
+{
+  return GetConfiguration().mode;
+}
+
+uint64_t RAINIERSampler::GetSeed()
+{
+  return GetConfiguration().seed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERSampler::ParseMode(const std::string& name, Mode& mode)
+{
+  for (Mode m : { kSequential, kShuffle, kStratified }) {
+    if (name == ModeName(m)) {
+      mode = m;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* RAINIERSampler::ModeName(Mode mode)
+{
+  switch (mode) {
+    case kShuffle:    return "shuffle";
+    case kStratified: return "stratified";
+    default:          return "sequential";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERSampler::RAINIERSampler(const RAINIERCascadeStore& store, G4int thread)
+: fShareSize(0),
+  fLibrarySize(store.GetNumberOfCascades()),
+  fDraws(0),
+  fEngine(SplitMix64(GetConfiguration().seed ^ SplitMix64((uint64_t)(thread + 1))))
+{
+  // Every nThreads-th cascade; a thread left without any (more threads
+  // than cascades) takes the whole library
+  G4int nThreads = GetConfiguration().nThreads;
+  G4long first = 0, stride = 1;
+  if (thread >= 0 && nThreads > 1 && thread % nThreads < fLibrarySize) {
+    first = thread % nThreads;
+    stride = nThreads;
+  }
+
+  // One stratum per multiplicity, or a single one
+  G4bool stratified = GetConfiguration().mode == kStratified;
+  std::map<size_t, size_t> strata;
+  for (G4long cascade = first; cascade < fLibrarySize; cascade += stride) {
+    size_t key = stratified ? store.NumberOfGammas(cascade) : 0;
+    std::map<size_t, size_t>::iterator it = strata.find(key);
+    if (it == strata.end()) {
+      it = strata.insert(std::make_pair(key, fStrata.size())).first;
+      fStrata.push_back(Stratum());
+      fStrata.back().next = 0;
+      fStrata.back().credit = 0;
+    }
+    fStrata[it->second].cascades.push_back(cascade);
+    fShareSize++;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERSampler::Stratum& RAINIERSampler::Choose()
+{
+  if (fStrata.size() == 1) return fStrata.front();
+
+  // Smooth weighted round-robin with the stratum sizes as weights: over
+  // every fShareSize draws stratum k is chosen exactly size(k) times, and
+  // as evenly spread as integer counts allow
+  Stratum* chosen = &fStrata.front();
+  for (Stratum& stratum : fStrata) {
+    stratum.credit += stratum.cascades.size();
+    if (stratum.credit > chosen->credit) chosen = &stratum;
+  }
+  chosen->credit -= fShareSize;
+  return *chosen;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long RAINIERSampler::Next(G4long& position)
+{
+  if (fShareSize == 0) return -1;
+  G4long pass = fDraws / fShareSize;
+  fDraws++;
+
+  // One Fisher-Yates step: the first next cascades have been drawn this
+  // pass; swap a random one of the rest into place. After the last one
+  // the current order is shuffled again from the start.
+  Stratum& stratum = Choose();
+  std::vector<G4long>& cascades = stratum.cascades;
+  if (stratum.next == cascades.size()) stratum.next = 0;
+  std::uniform_int_distribution<size_t> pick(stratum.next, cascades.size() - 1);
+  std::swap(cascades[stratum.next], cascades[pick(fEngine)]);
+  G4long cascade = cascades[stratum.next++];
+
+  position = pass * fLibrarySize + cascade;
+  return cascade;
+}
@@ -0,0 +1,293 @@
+// ==============================================================================
+// RAINIERStreamReader.cc - RAINIER cascades streamed by a reader thread
+// ==============================================================================
+
+#include "RAINIERStreamReader.hh"
+#include "CascadeFilter.hh"
+#include "RAINIERCursor.hh"
+
+// ROOT configuration must see std::string_view support before including TFile/TTree
+#include "RConfigure.h"
+#ifndef R__HAS_STD_STRING_VIEW
+#define R__HAS_STD_STRING_VIEW 1
+#endif
+
+#include "TChain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+// External global variable for quiet mode
+extern bool g_quietMode;
+
+namespace {
+
+// Read-ahead of the TTreeCache used by the reader thread
+const Long64_t kCacheSize = 64*1024*1024;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERStreamReader* RAINIERStreamReader::Instance()
+{
+  static RAINIERStreamReader instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERStreamReader::RAINIERStreamReader()
+: fMask(0),
+  fEnqueue(0),
+  fDequeue(0),
+  fTree(nullptr),
+  fFilter(nullptr),
+  fEntries(nullptr),
+  fActive(false),
+  fStop(false),
+  fFinished(false),
+  fPushed(0),
+  fPopped(0),
+  fDepthSum(0),
+  fStalls(0),
+  fStallNs(0),
+  fFullWaits(0)
+{}
+
+RAINIERStreamReader::~RAINIERStreamReader()
+{
+  Stop();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERStreamReader::Start(const std::vector<std::string>& files, const std::string& treeName,
+                                  const CascadeFilter& filter, G4int depth,
+                                  const std::vector<G4long>* entries)
+{
+  if (IsActive()) return true;
+
+  // The files have been checked by RAINIERFileList; the reader goes
+  // through all of them, one after the other
+  TChain* chain = new TChain(treeName.c_str());
+  for (const std::string& file : files) {
+    chain->Add(file.c_str());
+  }
+  fTree = chain;
+  if (fTree->GetEntries() <= 0) {
+    G4cerr << "ERROR: No entries in tree '" << treeName << "' of the RAINIER files" << G4endl;
+    delete fTree;
+    fTree = nullptr;
+    return false;
+  }
+  fEntries = entries;
+  RAINIERCursor::Instance()->Attach(entries ? (G4long)entries->size() : fTree->GetEntries());
+
+  // Ring of a power-of-two number of slots; slot i is free for push i
+  size_t size = 1;
+  while (size < (size_t)std::max(depth, 2)) size <<= 1;
+  fSlots.reset(new Slot[size]);
+  for (size_t i = 0; i < size; i++) fSlots[i].sequence.store(i, std::memory_order_relaxed);
+  fMask = size - 1;
+  fEnqueue.store(0, std::memory_order_relaxed);
+  fDequeue.store(0, std::memory_order_relaxed);
+
+  fFileName = files.size() == 1 ? files.front() : std::to_string(files.size()) + " files";
+  fFilter = &filter;
+  fStop.store(false, std::memory_order_relaxed);
+  fFinished.store(false, std::memory_order_relaxed);
+  fActive.store(true, std::memory_order_release);
+  fThread = std::thread(&RAINIERStreamReader::Read, this);
+
+  if (!g_quietMode) {
+    G4cout << "RAINIER stream: reader thread started on " << fFileName << " ("
+           << (fEntries ? (Long64_t)fEntries->size() : fTree->GetEntries())
+           << (fEntries ? " accepted" : "") << " entries, ring of " << size << " cascades)" << G4endl;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERStreamReader::Stop()
+{
+  if (!fThread.joinable()) return;
+  fStop.store(true, std::memory_order_release);
+  fThread.join();
+  fActive.store(false, std::memory_order_release);
+
+  delete fTree;  // closes the files of the chain
+  fTree = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERStreamReader::Read()
+{
+  // Only Egs is read (and Exfs for a level criterion), through a cache that
+  // fetches whole clusters of baskets at once; vector branches cannot use
+  // ROOT's bulk I/O
+  std::vector<Double_t>* egs = nullptr;
+  std::vector<Double_t>* exfs = nullptr;
+  fTree->SetBranchStatus("*", 0);
+  fTree->SetBranchStatus("Egs", 1);
+  fTree->SetBranchAddress("Egs", &egs);
+  fTree->SetCacheSize(kCacheSize);
+  fTree->AddBranchToCache("Egs", true);
+  if (fFilter->NeedsLevels() && !fEntries) {
+    fTree->SetBranchStatus("Exfs", 1);
+    fTree->SetBranchAddress("Exfs", &exfs);
+    fTree->AddBranchToCache("Exfs", true);
+  }
+  fTree->StopCacheLearningPhase();
+
+  Long64_t nEntries = fEntries ? (Long64_t)fEntries->size() : fTree->GetEntries();
+  RAINIERCursor* cursor = RAINIERCursor::Instance();
+  std::vector<G4double> energies;
+  Long64_t skippedInARow = 0;
+
+  // Entries in order, starting again from the first one after the last;
+  // the position counts on across passes
+  for (G4long position = 0; !fStop.load(std::memory_order_acquire); position++) {
+    fTree->GetEntry(fEntries ? (*fEntries)[position % nEntries] : position % nEntries);
+    // Exfs ends with the level the cascade stops at; the rest are intermediate
+    size_t nLevels = exfs && !exfs->empty() ? exfs->size() - 1 : 0;
+    if (!egs || (!fEntries &&
+                 !fFilter->Accept(egs->data(), egs->size(), exfs ? exfs->data() : nullptr, nLevels))) {
+      cursor->RecordSkipped();
+      if (++skippedInARow >= nEntries) {
+        G4cerr << "ERROR: No usable cascade in RAINIER input " << fFileName
+               << (fFilter->IsActive() ? " (filter " + fFilter->GetDescription() + ")" : "") << G4endl;
+        break;
+      }
+      continue;
+    }
+    skippedInARow = 0;
+
+    energies.assign(egs->begin(), egs->end());
+    while (!TryPush(position, energies)) {
+      fFullWaits.fetch_add(1, std::memory_order_relaxed);
+      if (fStop.load(std::memory_order_acquire)) break;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  fTree->ResetBranchAddresses();
+  delete egs;
+  delete exfs;
+  fFinished.store(true, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERStreamReader::TryPush(G4long position, std::vector<G4double>& energies)
+{
+  size_t pos = fEnqueue.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &fSlots[pos & fMask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)pos;
+    if (difference == 0) {
+      if (fEnqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (difference < 0) {
+      return false;  // full
+    } else {
+      pos = fEnqueue.load(std::memory_order_relaxed);
+    }
+  }
+  slot->position = position;
+  slot->energies.swap(energies);
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  fPushed.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERStreamReader::TryPop(std::vector<G4double>& energies, G4long& position)
+{
+  size_t pos = fDequeue.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &fSlots[pos & fMask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)(pos + 1);
+    if (difference == 0) {
+      if (fDequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (difference < 0) {
+      return false;  // empty
+    } else {
+      pos = fDequeue.load(std::memory_order_relaxed);
+    }
+  }
+  position = slot->position;
+  slot->energies.swap(energies);
+  slot->sequence.store(pos + fMask + 1, std::memory_order_release);
+
+  // Cascades still in the ring after this one
+  G4long depth = (G4long)fEnqueue.load(std::memory_order_relaxed) - (G4long)(pos + 1);
+  fDepthSum.fetch_add(std::max(depth, 0L), std::memory_order_relaxed);
+  fPopped.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERStreamReader::Pop(std::vector<G4double>& energies, G4long& position)
+{
+  if (TryPop(energies, position)) return true;
+
+  // Ring empty: the reader is behind. Spin briefly, then sleep.
+  fStalls.fetch_add(1, std::memory_order_relaxed);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  G4bool found = false;
+  for (G4int attempt = 0; !found; attempt++) {
+    if (attempt < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    found = TryPop(energies, position);
+    if (!found && fFinished.load(std::memory_order_acquire)) {
+      found = TryPop(energies, position);
+      break;
+    }
+  }
+  fStallNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start).count(),
+                     std::memory_order_relaxed);
+  return found;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RAINIERStreamReader::PrintStatistics() const
+{
+  if (!fSlots) return;
+
+  G4long popped = fPopped.load(std::memory_order_relaxed);
+  G4long stalls = fStalls.load(std::memory_order_relaxed);
+  G4double meanDepth = popped > 0 ? G4double(fDepthSum.load(std::memory_order_relaxed)) / popped : 0.;
+
+  G4cout << "RAINIER stream: " << fPushed.load(std::memory_order_relaxed) << " cascades queued, "
+         << popped << " used; ring of " << fMask + 1 << ", mean depth "
+         << std::fixed << std::setprecision(1) << meanDepth << G4endl;
+  G4cout << "  workers waited on an empty ring " << stalls << " times ("
+         << fStallNs.load(std::memory_order_relaxed) / 1.e6 << " ms in total)"
+         << ", reader waited on a full ring " << fFullWaits.load(std::memory_order_relaxed)
+         << " times" << G4endl;
+  G4cout << std::defaultfloat << std::setprecision(6);
+  if (popped > 0 && stalls > popped / 100) {
+    // A ring that is nearly empty on average means the reader is slower
+    // than the workers; one that is often deep but sometimes dry means
+    // bursts that a deeper ring can absorb
+    if (meanDepth < 0.1 * (fMask + 1)) {
+      G4cout << "  the reader is slower than the workers; a deeper ring will not help" << G4endl;
+    } else {
+      G4cout << "  a deeper ring (-rainier-stream <depth>) would absorb the stalls" << G4endl;
+    }
+  }
+}
@@ -0,0 +1,254 @@
+// ==============================================================================
+// RAINIERTextReader.cc - Streaming parser for text lists of gamma cascades
+// ==============================================================================
+
+#include "RAINIERTextReader.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Powers of ten that are exact in a double
+const G4double kPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Unparsable lines printed before the rest are only counted
+const G4long kBadLinesShown = 5;
+
+// Columns of a gamma_pairs.txt row: n level Eint Jpi E1 E2 BR
+const G4int kPairColumns = 7;
+
+inline G4bool IsBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline G4bool IsSeparator(char c)
+{
+  return IsBlank(c) || c == ',' || c == ':';
+}
+
+inline G4bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RAINIERTextReader::RAINIERTextReader(const std::string& fileName)
+: fFileName(fileName),
+  fFile(std::fopen(fileName.c_str(), "rb")),
+  fBuffer(kBufferSize),
+  fBegin(0),
+  fEnd(0),
+  fEndOfFile(false),
+  fLineNumber(0),
+  fBadLines(0),
+  fBytesRead(0)
+{
+  // Data goes straight from the file into fBuffer, not through stdio's
+  if (fFile) std::setvbuf(fFile, nullptr, _IONBF, 0);
+}
+
+RAINIERTextReader::~RAINIERTextReader()
+{
+  if (fFile) std::fclose(fFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERTextReader::NextLine(const char*& begin, const char*& end)
+{
+  if (!fFile) return false;
+  while (true) {
+    const char* data = fBuffer.data();
+    const char* newline = (const char*)std::memchr(data + fBegin, '\n', fEnd - fBegin);
+    if (newline) {
+      begin = data + fBegin;
+      end = newline;
+      fBegin = newline - data + 1;
+      return true;
+    }
+    if (fEndOfFile) {
+      if (fBegin == fEnd) return false;
+      begin = data + fBegin;   // last line without a newline
+      end = data + fEnd;
+      fBegin = fEnd;
+      return true;
+    }
+
+    // Keep the partial line, and make room for a line longer than the buffer
+    size_t rest = fEnd - fBegin;
+    if (fBegin > 0) std::memmove(fBuffer.data(), fBuffer.data() + fBegin, rest);
+    fBegin = 0;
+    fEnd = rest;
+    if (fEnd == fBuffer.size()) fBuffer.resize(2 * fBuffer.size());
+
+    size_t n = std::fread(fBuffer.data() + fEnd, 1, fBuffer.size() - fEnd, fFile);
+    fEnd += n;
+    fBytesRead += n;
+    if (n == 0) fEndOfFile = true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERTextReader::ParseNumber(const char*& p, const char* end, G4double& value)
+{
+  const char* q = p;
+  G4bool negative = false;
+  if (q < end && (*q == '-' || *q == '+')) negative = (*q++ == '-');
+
+  // Up to 19 significant digits in an integer mantissa, the rest only
+  // shift the decimal exponent
+  std::uint64_t mantissa = 0;
+  G4int digits = 0;
+  G4int exponent = 0;
+  G4bool any = false;
+  for (; q < end && IsDigit(*q); q++, any = true) {
+    if (digits < 19) {
+      mantissa = 10 * mantissa + (*q - '0');
+      if (mantissa > 0) digits++;
+    } else {
+      exponent++;
+    }
+  }
+  if (q < end && *q == '.') {
+    for (q++; q < end && IsDigit(*q); q++, any = true) {
+      if (digits < 19) {
+        mantissa = 10 * mantissa + (*q - '0');
+        if (mantissa > 0) digits++;
+        exponent--;
+      }
+    }
+  }
+  if (!any) return false;
+
+  if (q < end && (*q == 'e' || *q == 'E')) {
+    q++;
+    G4bool negativeExponent = false;
+    if (q < end && (*q == '-' || *q == '+')) negativeExponent = (*q++ == '-');
+    if (q == end || !IsDigit(*q)) return false;
+    G4int e = 0;
+    for (; q < end && IsDigit(*q); q++) {
+      if (e < 10000) e = 10 * e + (*q - '0');
+    }
+    exponent += negativeExponent ? -e : e;
+  }
+  if (q < end && !IsSeparator(*q)) return false;
+
+  value = (G4double)mantissa;
+  if (exponent >= 0 && exponent <= 22) {
+    value *= kPow10[exponent];
+  } else if (exponent < 0 && exponent >= -22) {
+    value /= kPow10[-exponent];
+  } else if (mantissa != 0) {
+    value *= std::pow(10., exponent);
+  }
+  if (negative) value = -value;
+  p = q;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERTextReader::ParseLine(const char* begin, const char* end,
+                                    std::vector<G4double>& energies, G4double& intensity)
+{
+  energies.clear();
+  intensity = 1.;
+
+  // "I: E1 E2 ..." gives the intensity before the colon
+  const char* p = begin;
+  const char* colon = (const char*)std::memchr(begin, ':', end - begin);
+  if (colon) {
+    if (!ParseNumber(p, colon, intensity)) return false;
+    while (p < colon && IsBlank(*p)) p++;
+    if (p != colon) return false;
+    p = colon + 1;
+  }
+
+  // Fast path: a line of energies
+  G4bool numeric = true;
+  while (true) {
+    while (p < end && (IsBlank(*p) || *p == ',')) p++;
+    if (p == end) break;
+    G4double energy;
+    if (!ParseNumber(p, end, energy) || (p < end && *p == ':')) {
+      numeric = false;
+      break;
+    }
+    energies.push_back(energy);
+  }
+  if (numeric) return !energies.empty();
+  if (colon) return false;
+
+  // Otherwise a gamma_pairs.txt row, split into its columns
+  const char* column[kPairColumns + 1];
+  G4int nColumns = 0;
+  for (p = begin; p < end && nColumns <= kPairColumns; ) {
+    while (p < end && IsBlank(*p)) p++;
+    if (p == end) break;
+    column[nColumns++] = p;
+    while (p < end && !IsBlank(*p)) p++;
+  }
+  if (nColumns != kPairColumns) return false;
+
+  G4double values[kPairColumns];
+  for (G4int i = 0; i < kPairColumns; i++) {
+    const char* q = column[i];
+    G4bool isNumber = ParseNumber(q, end, values[i]);
+    if (isNumber == (i == 3)) return false;   // only the spin-parity is not a number
+  }
+  energies.assign(values + 4, values + 6);
+  intensity = values[6];
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERTextReader::Next(std::vector<G4double>& energies, G4double& intensity)
+{
+  const char* begin;
+  const char* end;
+  while (NextLine(begin, end)) {
+    fLineNumber++;
+    while (begin < end && IsBlank(*begin)) begin++;
+    if (begin == end || *begin == '#') continue;
+    if (ParseLine(begin, end, energies, intensity)) return true;
+
+    if (++fBadLines <= kBadLinesShown) {
+      G4cerr << "WARNING: Cannot parse line " << fLineNumber << " of " << fFileName << ": "
+             << std::string(begin, std::min<size_t>(end - begin, 80)) << G4endl;
+    }
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RAINIERTextReader::IsCascadeText(const std::string& fileName)
+{
+  size_t dot = fileName.find_last_of('.');
+  std::string extension = dot == std::string::npos ? "" : fileName.substr(dot);
+  if (extension == ".dat") return true;
+  if (extension != ".txt") return false;
+
+  RAINIERTextReader reader(fileName);
+  const char* begin;
+  const char* end;
+  while (reader.NextLine(begin, end)) {
+    while (begin < end && IsBlank(*begin)) begin++;
+    if (begin == end || *begin == '#') continue;
+    G4double value;
+    return ParseNumber(begin, end, value);
+  }
+  return false;
+}
@@ -3,6 +3,7 @@
 
 #include "Run.hh"
 #include "EventAction.hh"  // Include to get full CoincidenceEvent definition
+#include "EmissionBiasing.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 #include <fstream>
@@ -18,7 +19,11 @@ Run::Run()
   fTotalEnergyDepositDet1(0.),
   fTotalEnergyDepositDet2(0.),
   fTotalEventsDet1(0),
-  fTotalEventsDet2(0)
+  fTotalEventsDet2(0),
+  fWeightSumDet1(0.),
+  fWeightSumDet2(0.),
+  fWeightSquaredSumDet1(0.),
+  fWeightSquaredSumDet2(0.)
 {
 }
 
@@ -48,32 +53,40 @@ void Run::Merge(const G4Run* run)
     fTotalEnergyDepositDet2 += localRun->fTotalEnergyDepositDet2;
     fTotalEventsDet1 += localRun->fTotalEventsDet1;
     fTotalEventsDet2 += localRun->fTotalEventsDet2;
+    fWeightSumDet1 += localRun->fWeightSumDet1;
+    fWeightSumDet2 += localRun->fWeightSumDet2;
+    fWeightSquaredSumDet1 += localRun->fWeightSquaredSumDet1;
+    fWeightSquaredSumDet2 += localRun->fWeightSquaredSumDet2;
     
     G4Run::Merge(run);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::AddEnergySpectrumDet1(G4double energy)
+void Run::AddEnergySpectrumDet1(G4double energy, G4double weight)
 {
     G4int bin = EnergyToBin(energy);
     if (bin >= 0 && bin < fNbins) {
-        fEnergyHistogramDet1[bin]++;
+        fEnergyHistogramDet1[bin] += weight;
     }
-    fTotalEnergyDepositDet1 += energy;
+    fTotalEnergyDepositDet1 += weight * energy;
     fTotalEventsDet1++;
+    fWeightSumDet1 += weight;
+    fWeightSquaredSumDet1 += weight * weight;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::AddEnergySpectrumDet2(G4double energy)
+void Run::AddEnergySpectrumDet2(G4double energy, G4double weight)
 {
     G4int bin = EnergyToBin(energy);
     if (bin >= 0 && bin < fNbins) {
-        fEnergyHistogramDet2[bin]++;
+        fEnergyHistogramDet2[bin] += weight;
     }
-    fTotalEnergyDepositDet2 += energy;
+    fTotalEnergyDepositDet2 += weight * energy;
     fTotalEventsDet2++;
+    fWeightSumDet2 += weight;
+    fWeightSquaredSumDet2 += weight * weight;
 }
 
 
@@ -90,6 +103,17 @@ G4int Run::EnergyToBin(G4double energy) const
 }
 
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintWeightedEvents(G4int events, G4double sum, G4double squaredSum) const
+{
+    // Kish's effective number of events, (sum w)^2 / sum w^2: the number of
+    // unweighted events that would give the same statistical precision
+    G4double effective = squaredSum > 0. ? sum * sum / squaredSum : 0.;
+    G4cout << "Weighted events: " << sum << " (" << events << " simulated, "
+           << effective << " effective)" << G4endl;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void Run::PrintResults() const
@@ -102,8 +126,14 @@ void Run::PrintResults() const
            << ", Total energy: " << G4BestUnit(fTotalEnergyDepositDet1, "Energy") << G4endl;
     G4cout << "Detector 2 - Total events: " << fTotalEventsDet2
            << ", Total energy: " << G4BestUnit(fTotalEnergyDepositDet2, "Energy") << G4endl;
+    if (EmissionBiasing::Instance()->IsActive()) {
+        G4cout << "Detector 1 - ";
+        PrintWeightedEvents(fTotalEventsDet1, fWeightSumDet1, fWeightSquaredSumDet1);
+        G4cout << "Detector 2 - ";
+        PrintWeightedEvents(fTotalEventsDet2, fWeightSumDet2, fWeightSquaredSumDet2);
+    }
 
-    // Peak analysis for single detectors
+    // Peak analysis for single detectors (weighted counts)
     G4cout << "\n=== SIGNIFICANT PEAKS (>10 counts) ===" << G4endl;
     G4cout << "Detector 1:" << G4endl;
     for (const auto& bin : fEnergyHistogramDet1) {
@@ -5,6 +5,11 @@
 #include "PrimaryGeneratorAction.hh"
 #include "DetectorConstruction.hh"
 #include "Run.hh"
+#include "CascadeFilter.hh"
+#include "EmissionBiasing.hh"
+#include "G4CASCADELevelCache.hh"
+#include "RAINIERCursor.hh"
+#include "RAINIERStreamReader.hh"
 
 #include "G4RunManager.hh"
 #include "G4Run.hh"
@@ -21,7 +26,11 @@ RunAction::RunAction()
   fEnergyDepositDet1("EnergyDepositDet1", 0.),
   fEnergyDepositDet2("EnergyDepositDet2", 0.),
   fEventCountDet1("EventCountDet1", 0),
-  fEventCountDet2("EventCountDet2", 0)
+  fEventCountDet2("EventCountDet2", 0),
+  fWeightedCountDet1("WeightedCountDet1", 0.),
+  fWeightedCountDet2("WeightedCountDet2", 0.),
+  fWeightSquaredDet1("WeightSquaredDet1", 0.),
+  fWeightSquaredDet2("WeightSquaredDet2", 0.)
 {
     // Register accumulables to the accumulable manager
     G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
@@ -29,6 +38,10 @@ RunAction::RunAction()
     accumulableManager->Register(fEnergyDepositDet2);
     accumulableManager->Register(fEventCountDet1);
     accumulableManager->Register(fEventCountDet2);
+    accumulableManager->Register(fWeightedCountDet1);
+    accumulableManager->Register(fWeightedCountDet2);
+    accumulableManager->Register(fWeightSquaredDet1);
+    accumulableManager->Register(fWeightSquaredDet2);
 
     // Setup G4AnalysisManager for thread-safe ROOT output
     auto analysisManager = G4AnalysisManager::Instance();
@@ -42,6 +55,7 @@ RunAction::RunAction()
     analysisManager->CreateNtuple("Tree", "All detector events from dual HPGe detectors");
     analysisManager->CreateNtupleDColumn("e1");  // Detector 1 energy (keV)
     analysisManager->CreateNtupleDColumn("e2");  // Detector 2 energy (keV)
+    analysisManager->CreateNtupleDColumn("w");   // Event weight (1 unless -bias-cones)
     analysisManager->FinishNtuple();
 }
 
@@ -80,6 +94,13 @@ void RunAction::BeginOfRunAction(const G4Run*)
 
 void RunAction::EndOfRunAction(const G4Run* run)
 {
+    // Each worker ends its run before the master prints the statistics
+    // below; in a sequential run this thread does both
+    const PrimaryGeneratorAction* generatorAction
+     = static_cast<const PrimaryGeneratorAction*>
+       (G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+    if (generatorAction) generatorAction->FlushStatistics();
+
     G4int nofEvents = run->GetNumberOfEvent();
     if (nofEvents == 0) return;
 
@@ -87,14 +108,16 @@ void RunAction::EndOfRunAction(const G4Run* run)
     G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
     accumulableManager->Merge();
 
-    // Compute dose for detector 1
+    // Compute dose for detector 1; the deposits are weighted sums, so they
+    // go with the summed weights rather than the simulated event count
     G4double energyDepositDet1 = fEnergyDepositDet1.GetValue();
     G4double energyDepositDet12 = energyDepositDet1 * energyDepositDet1;
     G4int eventCountDet1 = fEventCountDet1.GetValue();
+    G4double weightedCountDet1 = fWeightedCountDet1.GetValue();
     
     G4double rmsDet1 = 0.;
-    if (eventCountDet1 > 0) {
-        rmsDet1 = energyDepositDet12 - energyDepositDet1*energyDepositDet1/eventCountDet1;
+    if (weightedCountDet1 > 0.) {
+        rmsDet1 = energyDepositDet12 - energyDepositDet1*energyDepositDet1/weightedCountDet1;
         if (rmsDet1 > 0.) rmsDet1 = std::sqrt(rmsDet1); 
     }
 
@@ -102,10 +125,11 @@ void RunAction::EndOfRunAction(const G4Run* run)
     G4double energyDepositDet2 = fEnergyDepositDet2.GetValue();
     G4double energyDepositDet22 = energyDepositDet2 * energyDepositDet2;
     G4int eventCountDet2 = fEventCountDet2.GetValue();
+    G4double weightedCountDet2 = fWeightedCountDet2.GetValue();
     
     G4double rmsDet2 = 0.;
-    if (eventCountDet2 > 0) {
-        rmsDet2 = energyDepositDet22 - energyDepositDet2*energyDepositDet2/eventCountDet2;
+    if (weightedCountDet2 > 0.) {
+        rmsDet2 = energyDepositDet22 - energyDepositDet2*energyDepositDet2/weightedCountDet2;
         if (rmsDet2 > 0.) rmsDet2 = std::sqrt(rmsDet2);
     }
 
@@ -123,9 +147,6 @@ void RunAction::EndOfRunAction(const G4Run* run)
     G4double rmsDoseDet2 = (eventCountDet2 > 0) ? rmsDet2/mass2 : 0.;
 
     // Run conditions
-    const PrimaryGeneratorAction* generatorAction
-     = static_cast<const PrimaryGeneratorAction*>
-       (G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
     G4String runCondition;
     if (generatorAction)
     {
@@ -136,7 +157,9 @@ void RunAction::EndOfRunAction(const G4Run* run)
       runCondition += G4BestUnit(particleEnergy,"Energy");
     }
 
-    // Print results for both detectors
+    // Print results for both detectors; under -bias-cones the simulated
+    // counts overstate the acceptance, so the weighted ones are shown too
+    G4bool weighted = EmissionBiasing::Instance()->IsActive();
     if (IsMaster()) {
         G4cout
          << G4endl
@@ -148,23 +171,37 @@ void RunAction::EndOfRunAction(const G4Run* run)
          << G4endl << G4endl;
          
         G4cout << "=== DETECTOR 1 RESULTS ===" << G4endl;
-        G4cout << " Events with energy deposit: " << eventCountDet1 << G4endl;
-        G4cout << " Cumulative energy deposit: "
+        G4cout << " Events with energy deposit: " << eventCountDet1;
+        if (weighted) {
+            // Kish's effective count, (sum w)^2 / sum w^2
+            G4double squared = fWeightSquaredDet1.GetValue();
+            G4cout << " simulated (unweighted), " << weightedCountDet1 << " weighted, "
+                   << (squared > 0. ? weightedCountDet1 * weightedCountDet1 / squared : 0.) << " effective";
+        }
+        G4cout << G4endl;
+        G4cout << " Cumulative energy deposit" << (weighted ? " (weighted): " : ": ")
          << G4BestUnit(energyDepositDet1,"Energy") << " rms = "
          << G4BestUnit(rmsDet1,"Energy")
          << G4endl
-         << " Dose in scoring volume : "
+         << " Dose in scoring volume" << (weighted ? " (weighted): " : " : ")
          << G4BestUnit(doseDet1,"Dose") << " rms = "
          << G4BestUnit(rmsDoseDet1,"Dose")
          << G4endl;
          
         G4cout << "=== DETECTOR 2 RESULTS ===" << G4endl;
-        G4cout << " Events with energy deposit: " << eventCountDet2 << G4endl;
-        G4cout << " Cumulative energy deposit: "
+        G4cout << " Events with energy deposit: " << eventCountDet2;
+        if (weighted) {
+            // Kish's effective count, (sum w)^2 / sum w^2
+            G4double squared = fWeightSquaredDet2.GetValue();
+            G4cout << " simulated (unweighted), " << weightedCountDet2 << " weighted, "
+                   << (squared > 0. ? weightedCountDet2 * weightedCountDet2 / squared : 0.) << " effective";
+        }
+        G4cout << G4endl;
+        G4cout << " Cumulative energy deposit" << (weighted ? " (weighted): " : ": ")
          << G4BestUnit(energyDepositDet2,"Energy") << " rms = "
          << G4BestUnit(rmsDet2,"Energy")
          << G4endl
-         << " Dose in scoring volume : "
+         << " Dose in scoring volume" << (weighted ? " (weighted): " : " : ")
          << G4BestUnit(doseDet2,"Dose") << " rms = "
          << G4BestUnit(rmsDoseDet2,"Dose")
          << G4endl
@@ -182,21 +219,39 @@ void RunAction::EndOfRunAction(const G4Run* run)
     Run* localRun = (Run*)run;
     if (IsMaster()) {
         localRun->PrintResults();
+
+        // Level-scheme cache usage (CASCADE mode only; silent otherwise)
+        G4CASCADELevelCache::Instance()->PrintStatistics();
+
+        // RAINIER entries shared out between the workers (RAINIER mode only)
+        RAINIERCursor::Instance()->PrintStatistics();
+        RAINIERStreamReader::Instance()->PrintStatistics();
+
+        // Cascades accepted by -filter / -two-gamma-only (silent without one)
+        CascadeFilter::Instance()->PrintStatistics();
     }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::AddEnergyDepositDet1(G4double edep)
+void RunAction::AddEnergyDepositDet1(G4double edep, G4double weight)
 {
-    fEnergyDepositDet1 += edep;
-    if (edep > 0.) fEventCountDet1 += 1;
+    fEnergyDepositDet1 += weight * edep;
+    if (edep > 0.) {
+        fEventCountDet1 += 1;
+        fWeightedCountDet1 += weight;
+        fWeightSquaredDet1 += weight * weight;
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::AddEnergyDepositDet2(G4double edep)
+void RunAction::AddEnergyDepositDet2(G4double edep, G4double weight)
 {
-    fEnergyDepositDet2 += edep;
-    if (edep > 0.) fEventCountDet2 += 1;
+    fEnergyDepositDet2 += weight * edep;
+    if (edep > 0.) {
+        fEventCountDet2 += 1;
+        fWeightedCountDet2 += weight;
+        fWeightSquaredDet2 += weight * weight;
+    }
 }
\ No newline at end of file